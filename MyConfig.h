@@ -60,9 +60,28 @@
  * - 'F': CPU frequency
  * - 'M': free memory
  * - 'E': clear MySensors EEPROM area and reboot (i.e. "factory" reset)
+ * - 'D': number of duplicated messages dropped by the transport
+ * - 'S': transport statistics as binary block (see canStats_t for the %CAN layout)
+ * - 'A': %CAN reassembly statistics as binary block (see canAssemblyStats_t), requires @ref MY_CAN_REASSEMBLY_STATS
+ * - 'O': outbox statistics as binary block (see outboxStats_t), requires @ref MY_OUTBOX_SIZE
+ * - 'P': core loop profiling as binary block (see profileGetStatistics()), requires @ref MY_CORE_PROFILING
+ * - 'G': gateway queue and link statistics as binary block (see gatewayQueueStats_t), requires
+ *   @ref MY_GATEWAY_TX_QUEUE_SIZE or @ref MY_GATEWAY_UART
+ * - 'B': gateway queue to the bus and mailbox as binary block (see gatewayBusStats_t), requires
+ *   @ref MY_GATEWAY_BUS_QUEUE_SIZE or @ref MY_GATEWAY_MAILBOX_SIZE
  */
 //#define MY_SPECIAL_DEBUG
 
+/**
+ * @def MY_CORE_PROFILING
+ * @brief Define this to measure the run time of _process(), transportProcessFIFO(), transportSend() and
+ * gatewayTransportAvailable() on the target, readable via I_DEBUG 'P'.
+ *
+ * Count, maximum and average duration in us are collected per section. Multiply by F_CPU/1000000
+ * to get cycles. Flash and RAM usage per feature flag are reported by the Arduino build output.
+ */
+//#define MY_CORE_PROFILING
+
 /**
  * @def MY_DISABLED_SERIAL
  * @brief Define MY_DISABLED_SERIAL if you want to use the UART TX/RX pins as normal I/O pins.
@@ -177,6 +196,54 @@
 #ifndef CAN_BUF_SIZE
 #define CAN_BUF_SIZE (8u)
 #endif
+/**
+ * @def CAN_DUP_CACHE_SIZE
+ * @brief Number of recently received messages remembered to drop duplicates before reassembly. 0 disables the cache.
+ *
+ * A message is identified by its sender, its 3 bit %CAN message id and a hash of its first frame.
+ */
+#ifndef CAN_DUP_CACHE_SIZE
+#define CAN_DUP_CACHE_SIZE (4u)
+#endif
+/**
+ * @def CAN_DUP_CACHE_TIMEOUT_MS
+ * @brief Time in ms a received message is remembered by the duplicate cache.
+ *
+ * The %CAN message id wraps after 8 messages. Entries of a sender are also expired once it is 4 ids ahead,
+ * but only messages passing the filters (to this node or broadcast) are seen. Keep this below the time a node
+ * needs to send 8 messages.
+ */
+#ifndef CAN_DUP_CACHE_TIMEOUT_MS
+#define CAN_DUP_CACHE_TIMEOUT_MS (500u)
+#endif
+/**
+ * @def MY_CAN_WAKE_ON_BUS
+ * @brief Define this to wake a sleeping node on %CAN bus activity.
+ *
+ * While the node sleeps the MCP2515 is in sleep mode with the wake up interrupt enabled, CAN_INT is used as
+ * additional wake up source (if the sketch leaves one free) and sleep() returns its interrupt number on a bus
+ * wake up. CAN_INT must be an external interrupt pin (pin 2 or 3 on ATmega328P). The frame that wakes the
+ * controller is lost, senders need to repeat it.
+ */
+//#define MY_CAN_WAKE_ON_BUS
+/**
+ * @def MY_CAN_REASSEMBLY_STATS
+ * @brief Define this to collect reassembly statistics for capacity planning, readable via I_DEBUG 'A'.
+ *
+ * Tracks the reassembly buffer occupancy (current and peak), continuation frames without matching slot and a
+ * histogram of the time from first to last frame of a message (buckets <1, <2, <4 ... <64, >=64 ms).
+ */
+//#define MY_CAN_REASSEMBLY_STATS
+/**
+ * @def CAN_LOAD_WINDOW_MS
+ * @brief Sliding window in ms for the bus load estimation.
+ *
+ * Frames are counted with their worst case length incl. stuff bits. Due to the acceptance filters a node
+ * only sees broadcasts and its own traffic, time lost in arbitration while sending is counted as load as well.
+ */
+#ifndef CAN_LOAD_WINDOW_MS
+#define CAN_LOAD_WINDOW_MS (2000u)
+#endif
 
 /**
  * @def MY_RS485_BAUD_RATE
@@ -320,7 +387,7 @@
  * @def MY_TRANSPORT_SANITY_CHECK
  * @brief If defined, will cause node to check transport in regular intervals to detect HW issues
  *        and re-initialize in case of failure.
- * @note This feature is enabled for all repeater nodes (incl. GW)
+ * @note This feature is enabled for all repeater nodes (incl. GW) and all %CAN nodes
  */
 //#define MY_TRANSPORT_SANITY_CHECK
 
@@ -331,6 +398,29 @@
 #ifndef MY_TRANSPORT_SANITY_CHECK_INTERVAL_MS
 #define MY_TRANSPORT_SANITY_CHECK_INTERVAL_MS (15*60*1000ul)
 #endif
+/**
+ * @def MY_BUS_LOAD_HIGH_PERCENT
+ * @brief Bus load (in percent) above which getBusLoadInterval() stretches send intervals and node
+ *        presentation is deferred.
+ */
+#ifndef MY_BUS_LOAD_HIGH_PERCENT
+#define MY_BUS_LOAD_HIGH_PERCENT (50u)
+#endif
+
+/**
+ * @def MY_BUS_LOAD_PRESENT_DEFER_MS
+ * @brief Max. time (in ms) node presentation is deferred while the bus load is high.
+ */
+#ifndef MY_BUS_LOAD_PRESENT_DEFER_MS
+#define MY_BUS_LOAD_PRESENT_DEFER_MS (10*1000ul)
+#endif
+
+/**
+ * @def MY_BUS_LOAD_HANDLER
+ * @brief Define this to provide your own busLoadHandler() policy.
+ */
+//#define MY_BUS_LOAD_HANDLER
+
 /**
  * @def MY_TRANSPORT_DISCOVERY_INTERVAL_MS
  * @brief This is a gateway-only feature: Interval (in ms) to issue network discovery checks
@@ -423,6 +513,115 @@
  *        Incompatible libraries are unable to send sensor data.
  */
 #define MY_CORE_COMPATIBILITY_CHECK
+
+/**
+ * @def MY_PENDING_REQUESTS
+ * @brief Number of asynchronous requests that can wait for their reply at the same time.
+ *
+ * Used by requestAsync() and transportPingNodeAsync(). Blocking waits (wait() for a message, transport
+ * waits) have two more entries of their own and never fail for lack of entries. Each entry takes 11 bytes
+ * of RAM.
+ */
+#ifndef MY_PENDING_REQUESTS
+#define MY_PENDING_REQUESTS (4u)
+#endif
+
+/**
+ * @def MY_DEFERRED_SLOTS
+ * @brief Number of internal replies that can wait for their send time (max. 8).
+ *
+ * Discovery responses (random delay up to 1s) and, on gateways faster than 16MHz, pong and
+ * registration responses (5ms) are sent from the process loop instead of blocking reception.
+ * If all slots are taken, a reply is sent immediately.
+ */
+#ifndef MY_DEFERRED_SLOTS
+#define MY_DEFERRED_SLOTS (4u)
+#endif
+
+/**
+ * @def MY_SCHEDULER_TASKS
+ * @brief Number of tasks of the cooperative scheduler (0 = disabled), see schedulerAdd().
+ *
+ * Tasks run from _process() when due. Sketches that call schedulerRun() from loop() only process
+ * the transport when there is work and idle the CPU in between. Idling needs CAN_INT on an external
+ * interrupt pin (pin 2 or 3 on ATmega328P), otherwise the CPU keeps polling. Each task takes 12 bytes
+ * of RAM.
+ */
+#ifndef MY_SCHEDULER_TASKS
+#define MY_SCHEDULER_TASKS (0u)
+#endif
+
+/**
+ * @def MY_SCHEDULER_PROCESS_MS
+ * @brief Max. interval (in ms) between _process() calls of schedulerRun() without CAN_INT activity.
+ */
+#ifndef MY_SCHEDULER_PROCESS_MS
+#define MY_SCHEDULER_PROCESS_MS (100ul)
+#endif
+
+/**
+ * @def MY_SCHEDULER_POWER_DOWN
+ * @brief Define this to let schedulerRun() sleep until the next task is due.
+ *
+ * Used if the next task is at least @ref MY_SCHEDULER_POWER_DOWN_MIN_MS away, the transport is ready and no
+ * reply is pending. The node does not receive while sleeping unless @ref MY_CAN_WAKE_ON_BUS is set.
+ * Not possible on repeaters, the CPU idles instead.
+ */
+//#define MY_SCHEDULER_POWER_DOWN
+
+/**
+ * @def MY_SCHEDULER_POWER_DOWN_MIN_MS
+ * @brief Min. time (in ms) until the next task for a power down, shorter gaps are spent in idle.
+ */
+#ifndef MY_SCHEDULER_POWER_DOWN_MIN_MS
+#define MY_SCHEDULER_POWER_DOWN_MIN_MS (100ul)
+#endif
+
+/**
+ * @def MY_OUTBOX_SIZE
+ * @brief Number of readings kept in RAM when sending fails (0 = disabled, nodes only).
+ *
+ * A C_SET to the gateway that cannot be sent (transport not ready, uplink failure) is stored with its
+ * capture time. Once the transport is ready again, stored readings are sent oldest first every
+ * @ref MY_OUTBOX_DRAIN_INTERVAL_MS, each followed by I_VALUE_AGE (age in seconds) for the same child.
+ * While readings are stored, new readings are stored behind them (send() returns false), so the
+ * controller receives readings in capture order. Each entry takes 37 bytes of RAM. If full, the oldest reading spills to EEPROM or is dropped.
+ * Statistics are readable via I_DEBUG 'O'.
+ */
+#ifndef MY_OUTBOX_SIZE
+#define MY_OUTBOX_SIZE (0u)
+#endif
+
+/**
+ * @def MY_OUTBOX_EEPROM_SIZE
+ * @brief Number of readings in the EEPROM ring behind the RAM outbox (0 = RAM only).
+ *
+ * The ring survives reboots and takes 3 + 37 * size bytes from @ref MY_OUTBOX_EEPROM_ADDRESS on.
+ * If full, the oldest reading is dropped. Readings stored before a reboot are sent with age 0xFFFFFFFF
+ * (unknown), the time the node was off is not known.
+ */
+#ifndef MY_OUTBOX_EEPROM_SIZE
+#define MY_OUTBOX_EEPROM_SIZE (0u)
+#endif
+
+/**
+ * @def MY_OUTBOX_EEPROM_ADDRESS
+ * @brief First EEPROM address of the outbox ring, the library uses no other EEPROM.
+ *
+ * The ring must end within the EEPROM (E2END), checked at compile time. With the default address an ATmega328P
+ * holds up to 13 readings, an ATmega168 (512 bytes) needs a lower address.
+ */
+#ifndef MY_OUTBOX_EEPROM_ADDRESS
+#define MY_OUTBOX_EEPROM_ADDRESS (512u)
+#endif
+
+/**
+ * @def MY_OUTBOX_DRAIN_INTERVAL_MS
+ * @brief Min. interval (in ms) between stored readings sent after the transport is ready again.
+ */
+#ifndef MY_OUTBOX_DRAIN_INTERVAL_MS
+#define MY_OUTBOX_DRAIN_INTERVAL_MS (100ul)
+#endif
 /** @}*/ // End of CoreSettingGrpPub group
 
 /**
@@ -444,7 +643,9 @@
  * @brief The wait period (in ms) before going to sleep when using smartSleep-functions.
  *
  * This period has to be long enough for controller to be able to send out
- * potential buffered messages.
+ * potential buffered messages. If the gateway holds messages for sleeping nodes
+ * (@ref MY_GATEWAY_MAILBOX_SIZE), they are sent after I_POST_SLEEP_NOTIFICATION and a
+ * few ms are sufficient.
  */
 #ifndef MY_SMART_SLEEP_WAIT_DURATION_MS
 #define MY_SMART_SLEEP_WAIT_DURATION_MS (500ul)
@@ -476,7 +677,9 @@
  */
 /**
  * @def MY_GATEWAY_MAX_RECEIVE_LENGTH
- * @brief Max buffersize needed for messages coming from controller.
+ * @brief Max length of lines coming from controller, longer lines are rejected.
+ *
+ * The serial gateway parses lines while they are received and needs no buffer of this size.
  */
 #ifndef MY_GATEWAY_MAX_RECEIVE_LENGTH
 #define MY_GATEWAY_MAX_RECEIVE_LENGTH (100u)
@@ -498,6 +701,117 @@
 #define MY_GATEWAY_MAX_CLIENTS (1u)
 #endif
 
+/**
+ * @def MY_GATEWAY_TX_QUEUE_SIZE
+ * @brief Number of messages to the controller that are queued while the serial TX buffer is full (0 = disabled).
+ *
+ * Without queue, a slow controller link blocks the gateway in the serial write and stalls bus reception.
+ * With queue, lines are only written when they fit into the TX buffer. Each entry takes one MyMessage
+ * and 7 bytes of RAM. Queued messages are written by priority class (C_SET/C_REQ/I_VALUE_AGE before C_INTERNAL/C_STREAM
+ * before C_PRESENTATION), oldest first within a class. Queue statistics are readable via I_DEBUG 'G'.
+ */
+#ifndef MY_GATEWAY_TX_QUEUE_SIZE
+#define MY_GATEWAY_TX_QUEUE_SIZE (0u)
+#endif
+
+/**
+ * @def MY_GATEWAY_TX_QUEUE_POLICY
+ * @brief Handling of a full @ref MY_GATEWAY_TX_QUEUE_SIZE queue.
+ *
+ * - GATEWAY_QUEUE_BLOCK: the next queued message is written blocking, no message is lost (default)
+ * - GATEWAY_QUEUE_DROP_OLDEST: the oldest message of the lowest priority class is dropped
+ * - GATEWAY_QUEUE_DROP_NEWEST: the newest message of the lowest priority class is dropped
+ *
+ * With the drop policies, a new message is dropped if all queued messages have a higher priority.
+ * I_VALUE_AGE is queued as C_SET and only dropped together with the value it belongs to.
+ */
+#ifndef MY_GATEWAY_TX_QUEUE_POLICY
+#define MY_GATEWAY_TX_QUEUE_POLICY (GATEWAY_QUEUE_BLOCK)
+#endif
+
+/**
+ * @def MY_GATEWAY_BUS_QUEUE_SIZE
+ * @brief Number of messages from controller queued for the bus (0 = disabled).
+ *
+ * Without queue, the gateway handles one controller message per loop and sends it directly, a failed
+ * send is lost. With queue, a burst of up to this many messages is read per loop and one queued message
+ * is sent per loop, by priority class as in @ref MY_GATEWAY_TX_QUEUE_SIZE. Failed sends are retried
+ * @ref MY_GATEWAY_BUS_RETRIES times with exponential backoff. Statistics are readable via I_DEBUG 'B'.
+ */
+#ifndef MY_GATEWAY_BUS_QUEUE_SIZE
+#define MY_GATEWAY_BUS_QUEUE_SIZE (0u)
+#endif
+
+/**
+ * @def MY_GATEWAY_BUS_QUEUE_POLICY
+ * @brief Handling of a full @ref MY_GATEWAY_BUS_QUEUE_SIZE queue, see @ref MY_GATEWAY_TX_QUEUE_POLICY.
+ *
+ * With GATEWAY_QUEUE_BLOCK, the next queued message is sent once without retry.
+ */
+#ifndef MY_GATEWAY_BUS_QUEUE_POLICY
+#define MY_GATEWAY_BUS_QUEUE_POLICY (GATEWAY_QUEUE_BLOCK)
+#endif
+
+/**
+ * @def MY_GATEWAY_VALUE_CACHE_SIZE
+ * @brief Number of (node, child, type) values cached by the gateway (0 = disabled, power of 2, max. 256).
+ *
+ * The gateway keeps the last C_SET value received from each node. A C_REQ from the controller is
+ * answered immediately from the cache with the C_SET value, followed by I_VALUE_AGE (age in seconds)
+ * from the same node and child. Without cached value, the request is forwarded to the node as usual.
+ * A C_SET from the controller invalidates the cached value until the node echoes or reports it.
+ * Each entry takes @ref MY_GATEWAY_VALUE_CACHE_PAYLOAD + 10 bytes of RAM. The table is open addressed,
+ * if all slots near the hash position are used the oldest value is replaced.
+ */
+#ifndef MY_GATEWAY_VALUE_CACHE_SIZE
+#define MY_GATEWAY_VALUE_CACHE_SIZE (0u)
+#endif
+
+/**
+ * @def MY_GATEWAY_VALUE_CACHE_PAYLOAD
+ * @brief Max. payload length stored in the value cache, longer values are not cached.
+ */
+#ifndef MY_GATEWAY_VALUE_CACHE_PAYLOAD
+#define MY_GATEWAY_VALUE_CACHE_PAYLOAD (8u)
+#endif
+
+/**
+ * @def MY_GATEWAY_VALUE_CACHE_FORWARD
+ * @brief Define this to forward C_REQ to the node even if answered from the value cache.
+ */
+//#define MY_GATEWAY_VALUE_CACHE_FORWARD
+
+/**
+ * @def MY_GATEWAY_MAILBOX_SIZE
+ * @brief Number of messages from controller held for sleeping nodes (0 = disabled).
+ *
+ * A node is considered asleep between its I_PRE_SLEEP_NOTIFICATION and I_POST_SLEEP_NOTIFICATION
+ * (or any other message from it). Messages from controller to a sleeping node are held and sent,
+ * one per loop, when it wakes up. Nodes can then use a short @ref MY_SMART_SLEEP_WAIT_DURATION_MS.
+ * If the mailbox is full, the oldest message is dropped. Statistics are part of I_DEBUG 'B'.
+ */
+#ifndef MY_GATEWAY_MAILBOX_SIZE
+#define MY_GATEWAY_MAILBOX_SIZE (0u)
+#endif
+
+/**
+ * @def MY_GATEWAY_BUS_RETRIES
+ * @brief Retries of a failed send from the @ref MY_GATEWAY_BUS_QUEUE_SIZE queue.
+ */
+#ifndef MY_GATEWAY_BUS_RETRIES
+#define MY_GATEWAY_BUS_RETRIES (3u)
+#endif
+
+/**
+ * @def MY_GATEWAY_BUS_RETRY_MS
+ * @brief Backoff (in ms) before the first retry, doubled for each further retry.
+ *
+ * MY_GATEWAY_BUS_RETRY_MS << @ref MY_GATEWAY_BUS_RETRIES has to stay below 32768.
+ */
+#ifndef MY_GATEWAY_BUS_RETRY_MS
+#define MY_GATEWAY_BUS_RETRY_MS (10u)
+#endif
+
 /**************************************
 * Ethernet Gateway Transport Defaults
 ***************************************/
@@ -508,6 +822,74 @@
 // The gateway options available
 //#define MY_GATEWAY_SERIAL
 
+/**
+ * @def MY_GATEWAY_BINARY_PROTOCOL
+ * @brief Define this to let the controller switch the serial gateway to the binary protocol.
+ *
+ * The gateway starts in the text protocol. A controller requests the binary protocol by sending
+ * I_VERSION with payload @ref MSG_GW_BINARY_HANDSHAKE, the gateway confirms with the same payload
+ * as last text line and uses binary frames in both directions. A text I_VERSION line (e.g. from a
+ * restarted controller) switches the gateway back to the text protocol. It is only accepted right
+ * after a delimiter or after @ref MY_GATEWAY_BINARY_IDLE_MS without input, so frame contents never
+ * switch the protocol.
+ *
+ * Frame: 0x00, COBS(sender, destination, version_length, command_echo_payload, type, sensor,
+ * payload, CRC-16/CCITT-FALSE little endian), 0x00. The leading delimiter is only sent with debug
+ * output enabled, debug lines stay text and end up between frames.
+ */
+//#define MY_GATEWAY_BINARY_PROTOCOL
+
+/**
+ * @def MY_GATEWAY_BINARY_IDLE_MS
+ * @brief Serial input pause (in ms) after which a text I_VERSION line is accepted in binary mode.
+ */
+#ifndef MY_GATEWAY_BINARY_IDLE_MS
+#define MY_GATEWAY_BINARY_IDLE_MS (100u)
+#endif
+
+/**
+ * @def MY_GATEWAY_UART
+ * @brief Define this to replace Serial by an interrupt driven USART0 driver (AVR only).
+ *
+ * The driver has configurable ring buffers, optional RTS/CTS flow control and uses double speed
+ * mode, i.e. @ref MY_BAUD_RATE of 500000 or 1000000 is exact at 16MHz. Overrun, framing error,
+ * dropped byte and TX backpressure counters are readable via I_DEBUG 'G'.
+ * @note Serial must not be used by the sketch, both drivers own the USART0 interrupt vectors.
+ */
+//#define MY_GATEWAY_UART
+
+/**
+ * @def MY_GATEWAY_UART_RX_SIZE
+ * @brief Size of the gateway UART receive ring (power of 2, max. 256).
+ */
+#ifndef MY_GATEWAY_UART_RX_SIZE
+#define MY_GATEWAY_UART_RX_SIZE (128u)
+#endif
+
+/**
+ * @def MY_GATEWAY_UART_TX_SIZE
+ * @brief Size of the gateway UART transmit ring (power of 2, max. 256).
+ */
+#ifndef MY_GATEWAY_UART_TX_SIZE
+#define MY_GATEWAY_UART_TX_SIZE (128u)
+#endif
+
+/**
+ * @def MY_GATEWAY_UART_RTS_PIN
+ * @brief Define this to the output pin connected to the controller's CTS input.
+ *
+ * Driven high when the receive ring is 3/4 full, low again when it is half empty.
+ */
+//#define MY_GATEWAY_UART_RTS_PIN (4)
+
+/**
+ * @def MY_GATEWAY_UART_CTS_PIN
+ * @brief Define this to the input pin connected to the controller's RTS output.
+ *
+ * Transmission pauses while the pin is high. The pin is polled by the driver, not interrupt driven.
+ */
+//#define MY_GATEWAY_UART_CTS_PIN (5)
+
 
 /**
 * @def MY_DEBUG_VERBOSE_GATEWAY
@@ -814,6 +1196,17 @@
 #ifndef MY_LINUX_CONFIG_FILE
 #define MY_LINUX_CONFIG_FILE "/etc/mysensors.conf"
 #endif
+
+/**
+ * @def MY_LINUX_IDLE_SLEEP_US
+ * @brief Maximum sleep of an idle _process() pass in us.
+ *
+ * No sleep while messages are processed, an idle loop backs off from 100us to this value.
+ * Lower values reduce the latency of the first message after an idle period at the cost of CPU load.
+ */
+#ifndef MY_LINUX_IDLE_SLEEP_US
+#define MY_LINUX_IDLE_SLEEP_US (10000ul)
+#endif
 /** @}*/ // End of LinuxSettingGrpPub group
 /** @}*/ // End of PlatformSettingGrpPub group
 
@@ -949,6 +1342,7 @@
 #define MY_DEBUG_OTA
 #define MY_DEBUG_OTA_DISABLE_ECHO
 #define MY_SPECIAL_DEBUG
+#define MY_CORE_PROFILING
 #define MY_DISABLED_SERIAL
 #define MY_SPLASH_SCREEN_DISABLED
 // linux
@@ -988,6 +1382,8 @@
 #define MY_DISABLE_RAM_ROUTING_TABLE_FEATURE
 #define MY_LOCK_DEVICE
 #define MY_SLEEP_HANDLER
+#define MY_BUS_LOAD_HANDLER
+#define MY_SCHEDULER_POWER_DOWN
 // core
 #define MY_CORE_ONLY
 // GW
@@ -1005,6 +1401,11 @@
 #define MY_GATEWAY_TINYGSM
 #define MY_GATEWAY_MQTT_CLIENT
 #define MY_GATEWAY_SERIAL
+#define MY_GATEWAY_BINARY_PROTOCOL
+#define MY_GATEWAY_VALUE_CACHE_FORWARD
+#define MY_GATEWAY_UART
+#define MY_GATEWAY_UART_RTS_PIN
+#define MY_GATEWAY_UART_CTS_PIN
 #define MY_IP_ADDRESS
 #define MY_IP_GATEWAY_ADDRESS
 #define MY_IP_SUBNET_ADDRESS
@@ -1050,6 +1451,8 @@
 // CAN
 #define MY_CAN
 #define MY_DEBUG_VERBOSE_CAN
+#define MY_CAN_WAKE_ON_BUS
+#define MY_CAN_REASSEMBLY_STATS
 // RF24
 #define MY_RADIO_RF24
 #define MY_RADIO_NRF24 //deprecated
@@ -65,6 +65,9 @@
 #include "hal/architecture/MyHwHAL.h"
 //#include "hal/crypto/MyCryptoHAL.h"
 #include "hal/architecture/AVR/MyHwAVR.cpp"
+#if defined(MY_GATEWAY_UART)
+#include "hal/architecture/AVR/drivers/GatewayUART/GatewayUART.cpp"
+#endif
 //#include "hal/crypto/AVR/MyCryptoAVR.cpp"
 #include "hal/architecture/MyHwHAL.cpp"
 
@@ -90,6 +93,8 @@
 #endif
 
 #include "core/MyIndication.cpp"
+#include "core/MyProfiling.cpp"
+#include "core/MyPendingRequest.cpp"
 
 #if defined(MY_GATEWAY_FEATURE)
 // GATEWAY - COMMON FUNCTIONS
@@ -102,7 +107,7 @@
 #endif
 
 // GATEWAY - CONFIGURATION
-#if defined(MY_SENSOR_NETWORK)
+#if defined(MY_GATEWAY_FEATURE) && defined(MY_SENSOR_NETWORK)
 // We assume that a gateway having a radio also should act as repeater
 #define MY_REPEATER_FEATURE
 #endif
@@ -120,7 +125,7 @@
 
 
 // SANITY CHECK
-#if defined(MY_REPEATER_FEATURE) || defined(MY_GATEWAY_FEATURE)
+#if defined(MY_REPEATER_FEATURE) || defined(MY_GATEWAY_FEATURE) || defined(MY_CAN)
 #define MY_TRANSPORT_SANITY_CHECK		//!< enable regular transport sanity checks
 
 #endif
@@ -128,6 +133,7 @@
 // TRANSPORT INCLUDES
 #include "hal/transport/MyTransportHAL.h"
 #include "core/MyTransport.h"
+#include "core/MyDeferred.h"
 
 // PARENT CHECK
 #if defined(MY_PARENT_NODE_IS_STATIC) && (MY_PARENT_NODE_ID == AUTO)
@@ -168,6 +174,9 @@
 
 
 #include "core/MyTransport.cpp"
+#include "core/MyDeferred.cpp"
+#include "core/MyOutbox.cpp"
+#include "core/MyScheduler.cpp"
 
 
 // Make sure to disable child features when parent feature is disabled
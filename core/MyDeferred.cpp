@@ -0,0 +1,96 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include "MyDeferred.h"
+
+// global variables
+extern MyMessage _msgTmp;
+
+deferredReply_t _deferredReplies[MY_DEFERRED_SLOTS];
+uint8_t _deferredUsed = 0;	// bit n set: slot n pending
+
+void _deferredSend(const uint8_t destination, const uint8_t type, const uint8_t value)
+{
+	(void)transportRouteMessage(build(_msgTmp, destination, NODE_SENSOR_ID, C_INTERNAL,
+	                                  type).set(value));
+}
+
+void deferredReply(const uint32_t delayMs, const uint8_t destination, const uint8_t type,
+                   const uint8_t value)
+{
+	for (uint8_t slot = 0; slot < MY_DEFERRED_SLOTS; slot++) {
+		if (!(_deferredUsed & (1u << slot))) {
+			deferredReply_t &reply = _deferredReplies[slot];
+			reply.dueMs = hwMillis() + delayMs;
+			reply.destination = destination;
+			reply.type = type;
+			reply.value = value;
+			_deferredUsed |= (1u << slot);
+			return;
+		}
+	}
+	// late is worse than early: a blocked node drops incoming frames
+	DEFERRED_DEBUG(PSTR("!DFR:ADD:FULL,T=%" PRIu8 "\n"), type);
+	_deferredSend(destination, type, value);
+}
+
+void deferredProcess(const bool flush)
+{
+	if (!_deferredUsed) {
+		return;
+	}
+	const uint32_t now = hwMillis();
+	for (uint8_t slot = 0; slot < MY_DEFERRED_SLOTS; slot++) {
+		if ((_deferredUsed & (1u << slot)) && (flush ||
+		                                       (int32_t)(now - _deferredReplies[slot].dueMs) >= 0)) {
+			// copy and release first, the slot may be taken again while sending
+			const deferredReply_t reply = _deferredReplies[slot];
+			_deferredUsed &= ~(1u << slot);
+			DEFERRED_DEBUG(PSTR("DFR:SND:TO=%" PRIu8 ",T=%" PRIu8 "\n"), reply.destination, reply.type);
+			_deferredSend(reply.destination, reply.type, reply.value);
+		}
+	}
+}
+
+uint32_t deferredTimeToNext(void)
+{
+	uint32_t next = 0xFFFFFFFFul;
+	const uint32_t now = hwMillis();
+	for (uint8_t slot = 0; slot < MY_DEFERRED_SLOTS; slot++) {
+		if (_deferredUsed & (1u << slot)) {
+			const int32_t remaining = (int32_t)(_deferredReplies[slot].dueMs - now);
+			if (remaining <= 0) {
+				return 0;
+			}
+			if ((uint32_t)remaining < next) {
+				next = remaining;
+			}
+		}
+	}
+	return next;
+}
+
+uint8_t deferredPending(void)
+{
+	uint8_t count = 0;
+	for (uint8_t used = _deferredUsed; used; used >>= 1) {
+		count += used & 1u;
+	}
+	return count;
+}
@@ -0,0 +1,86 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/**
+ * @file MyDeferred.h
+ *
+ * Deferred internal replies (I_DISCOVER_RESPONSE, I_PONG, I_REGISTRATION_RESPONSE). Replies that
+ * have to wait (collision avoidance, slow nodes) are put into one of @ref MY_DEFERRED_SLOTS slots
+ * and sent from _process() when due, so reception continues in the meantime.
+ *
+ * Deferred log messages, format: [!]SYSTEM:[SUB SYSTEM:]MESSAGE
+ *
+ * |E| SYS | SUB | Message                   | Comment
+ * |-|-----|-----|---------------------------|---------------------------------------------------------------
+ * |!| DFR | ADD | FULL,T=%%d                | No free slot, reply of type (T) sent immediately
+ * | | DFR | SND | TO=%%d,T=%%d               | Deferred reply of type (T) sent to node (TO)
+ */
+
+#ifndef MyDeferred_h
+#define MyDeferred_h
+
+#if (MY_DEFERRED_SLOTS > 8u)
+#error MY_DEFERRED_SLOTS must not be larger than 8
+#endif
+
+#if defined(MY_DEBUG_VERBOSE_CORE)
+#define DEFERRED_DEBUG(x,...)	DEBUG_OUTPUT(x, ##__VA_ARGS__)	//!< debug output
+#else
+#define DEFERRED_DEBUG(x,...)									//!< debug NULL
+#endif
+
+/**
+ * @brief Pending reply, C_INTERNAL from this node with a single byte payload
+ */
+typedef struct {
+	uint32_t dueMs;			//!< hwMillis() when the reply is sent
+	uint8_t destination;	//!< receiver
+	uint8_t type;			//!< internal message type
+	uint8_t value;			//!< payload
+} deferredReply_t;
+
+/**
+ * @brief Send internal reply after delayMs without blocking, sent immediately if all slots are taken
+ * @param delayMs Delay in ms
+ * @param destination Receiver
+ * @param type Internal message type
+ * @param value Payload
+ */
+void deferredReply(const uint32_t delayMs, const uint8_t destination, const uint8_t type,
+                   const uint8_t value);
+
+/**
+ * @brief Send due replies
+ * @param flush Send all pending replies regardless of due time (before sleeping)
+ */
+void deferredProcess(const bool flush);
+
+/**
+ * @brief Time until the next pending reply is due
+ * @return ms, 0 if due, 0xFFFFFFFF if none pending
+ */
+uint32_t deferredTimeToNext(void);
+
+/**
+ * @brief Number of pending replies
+ * @return count
+ */
+uint8_t deferredPending(void);
+
+#endif
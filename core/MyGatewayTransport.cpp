@@ -25,9 +25,452 @@ extern bool transportSendRoute(MyMessage &message);
 extern MyMessage _msg;
 extern MyMessage _msgTmp;
 
-inline void gatewayTransportProcess(void)
+bool gatewayIsValueAge(const MyMessage &message)
+{
+	return message.getCommand() == C_INTERNAL && message.getType() == I_VALUE_AGE;
+}
+
+uint8_t gatewayMessagePriority(const MyMessage &message)
+{
+	const uint8_t command = message.getCommand();
+	// I_VALUE_AGE stays in the class of its C_SET, i.e. directly behind it
+	if (command == C_SET || command == C_REQ || gatewayIsValueAge(message)) {
+		return GATEWAY_PRIORITY_COMMAND;
+	}
+	if (command == C_PRESENTATION) {
+		return GATEWAY_PRIORITY_PRESENTATION;
+	}
+	return GATEWAY_PRIORITY_INTERNAL;
+}
+
+// slot of the I_VALUE_AGE queued directly behind a C_SET, see gatewayCacheAnswer() and outboxProcess()
+uint8_t _gatewayQueueValueAge(const gatewayQueue_t &queue, const uint8_t slot)
+{
+	const MyMessage &value = queue.messages[slot];
+	if (value.getCommand() != C_SET) {
+		return GATEWAY_QUEUE_NONE;
+	}
+	const uint8_t seq = queue.entries[slot].seq + 1;
+	for (uint8_t age = 0; age < queue.count; age++) {
+		const MyMessage &message = queue.messages[age];
+		if (queue.entries[age].seq == seq && gatewayIsValueAge(message) &&
+		        message.getSender() == value.getSender() && message.getSensor() == value.getSensor()) {
+			return age;
+		}
+	}
+	return GATEWAY_QUEUE_NONE;
+}
+
+// drop message from a full queue
+void _gatewayQueueDrop(gatewayQueue_t &queue, const uint8_t slot)
+{
+	queue.dropped++;
+	queue.count--;
+	queue.messages[slot] = queue.messages[queue.count];
+	queue.entries[slot] = queue.entries[queue.count];
+}
+
+// slot of the message to drop from a full queue, priority of new message passed in
+uint8_t _gatewayQueueVictim(const gatewayQueue_t &queue, const uint8_t priority)
+{
+	uint8_t victim = GATEWAY_QUEUE_NONE;
+	uint8_t victimPriority = priority;
+	uint8_t victimAge = 0;
+	for (uint8_t slot = 0; slot < queue.count; slot++) {
+		if (gatewayIsValueAge(queue.messages[slot])) {
+			// only dropped together with its value
+			continue;
+		}
+		const gatewayQueueEntry_t &entry = queue.entries[slot];
+		const uint8_t age = queue.seq - entry.seq;
+		bool select;
+		if (entry.priority != victimPriority) {
+			// lower class than all candidates so far
+			select = entry.priority > victimPriority;
+		} else if (victim == GATEWAY_QUEUE_NONE) {
+			// same class as the new message, which is the newest
+			select = (queue.policy == GATEWAY_QUEUE_DROP_OLDEST);
+		} else {
+			select = (queue.policy == GATEWAY_QUEUE_DROP_OLDEST) ? age > victimAge : age < victimAge;
+		}
+		if (select) {
+			victim = slot;
+			victimPriority = entry.priority;
+			victimAge = age;
+		}
+	}
+	return victim;
+}
+
+bool gatewayQueuePush(gatewayQueue_t &queue, const MyMessage &message)
+{
+	const uint8_t priority = gatewayMessagePriority(message);
+	bool lossless = true;
+	if (queue.count == queue.size) {
+		lossless = false;
+		const uint8_t victim = _gatewayQueueVictim(queue, priority);
+		if (victim == GATEWAY_QUEUE_NONE) {
+			// everything queued is more important or newer
+			queue.dropped++;
+			return false;
+		}
+		// an orphaned age would be taken for the age of the next value, drop the higher slot first
+		const uint8_t age = _gatewayQueueValueAge(queue, victim);
+		if (age != GATEWAY_QUEUE_NONE && age > victim) {
+			_gatewayQueueDrop(queue, age);
+		}
+		_gatewayQueueDrop(queue, victim);
+		if (age != GATEWAY_QUEUE_NONE && age < victim) {
+			_gatewayQueueDrop(queue, age);
+		}
+	}
+	const uint16_t nowMs = static_cast<uint16_t>(hwMillis());
+	gatewayQueueEntry_t &entry = queue.entries[queue.count];
+	queue.messages[queue.count] = message;
+	entry.queuedMs = nowMs;
+	entry.dueMs = nowMs;
+	entry.priority = priority;
+	entry.seq = queue.seq++;
+	entry.retries = 0;
+	queue.count++;
+	queue.queued++;
+	if (queue.count > queue.peak) {
+		queue.peak = queue.count;
+	}
+	return lossless;
+}
+
+uint8_t gatewayQueueNext(const gatewayQueue_t &queue, const bool dueOnly)
 {
-	if (gatewayTransportAvailable()) {
+	const uint16_t nowMs = static_cast<uint16_t>(hwMillis());
+	uint8_t next = GATEWAY_QUEUE_NONE;
+	uint8_t nextPriority = 0;
+	uint8_t nextAge = 0;
+	for (uint8_t slot = 0; slot < queue.count; slot++) {
+		const gatewayQueueEntry_t &entry = queue.entries[slot];
+		if (dueOnly && static_cast<int16_t>(nowMs - entry.dueMs) < 0) {
+			continue;
+		}
+		const uint8_t age = queue.seq - entry.seq;
+		if (next == GATEWAY_QUEUE_NONE || entry.priority < nextPriority ||
+		        (entry.priority == nextPriority && age > nextAge)) {
+			next = slot;
+			nextPriority = entry.priority;
+			nextAge = age;
+		}
+	}
+	return next;
+}
+
+void gatewayQueueRemove(gatewayQueue_t &queue, const uint8_t slot)
+{
+	const uint16_t waitMs = static_cast<uint16_t>(hwMillis()) - queue.entries[slot].queuedMs;
+	if (waitMs > queue.maxWaitMs) {
+		queue.maxWaitMs = waitMs;
+	}
+	queue.count--;
+	if (slot != queue.count) {
+		queue.messages[slot] = queue.messages[queue.count];
+		queue.entries[slot] = queue.entries[queue.count];
+	}
+}
+
+#if (MY_GATEWAY_BUS_QUEUE_SIZE > 0) && defined(MY_SENSOR_NETWORK)
+// dueMs is 16 bit and compared as signed difference
+static_assert(((uint32_t)MY_GATEWAY_BUS_RETRY_MS << MY_GATEWAY_BUS_RETRIES) < 32768ul,
+              "Bus retry backoff exceeds 32767ms, lower MY_GATEWAY_BUS_RETRY_MS or MY_GATEWAY_BUS_RETRIES");
+
+MyMessage _gatewayBusMessages[MY_GATEWAY_BUS_QUEUE_SIZE];	// messages from controller waiting for the bus
+gatewayQueueEntry_t _gatewayBusEntries[MY_GATEWAY_BUS_QUEUE_SIZE];
+gatewayQueue_t _gatewayBusQueue = { _gatewayBusMessages, _gatewayBusEntries, MY_GATEWAY_BUS_QUEUE_SIZE, MY_GATEWAY_BUS_QUEUE_POLICY, 0, 0, 0, 0, 0, 0 };
+uint16_t _gatewayBusRetries = 0;
+uint16_t _gatewayBusFailed = 0;
+
+// queue message from controller to the bus
+void _gatewayBusForward(const MyMessage &message)
+{
+	if (_gatewayBusQueue.count == MY_GATEWAY_BUS_QUEUE_SIZE &&
+	        MY_GATEWAY_BUS_QUEUE_POLICY == GATEWAY_QUEUE_BLOCK) {
+		GATEWAY_DEBUG(PSTR("!GWT:BSQ:FULL\n"));
+		// one attempt without backoff, the slot is needed
+		const uint8_t next = gatewayQueueNext(_gatewayBusQueue, false);
+		if (!transportSendRoute(_gatewayBusQueue.messages[next])) {
+			_gatewayBusFailed++;
+		}
+		gatewayQueueRemove(_gatewayBusQueue, next);
+	}
+	if (!gatewayQueuePush(_gatewayBusQueue, message)) {
+		GATEWAY_DEBUG(PSTR("!GWT:BSQ:DROP\n"));
+	}
+}
+
+// send next due message, failed sends are retried with exponential backoff
+void _gatewayBusService(void)
+{
+	const uint8_t next = gatewayQueueNext(_gatewayBusQueue, true);
+	if (next == GATEWAY_QUEUE_NONE) {
+		return;
+	}
+	_processActivity();
+	MyMessage &message = _gatewayBusQueue.messages[next];
+	if (transportSendRoute(message)) {
+		gatewayQueueRemove(_gatewayBusQueue, next);
+		return;
+	}
+	gatewayQueueEntry_t &entry = _gatewayBusQueue.entries[next];
+	if (entry.retries < MY_GATEWAY_BUS_RETRIES) {
+		entry.dueMs = static_cast<uint16_t>(hwMillis()) + (MY_GATEWAY_BUS_RETRY_MS << entry.retries);
+		entry.retries++;
+		_gatewayBusRetries++;
+		GATEWAY_DEBUG(PSTR("!GWT:BSQ:RETRY,TO=%" PRIu8 ",N=%" PRIu8 "\n"), message.getDestination(),
+		              entry.retries);
+	} else {
+		_gatewayBusFailed++;
+		GATEWAY_DEBUG(PSTR("!GWT:BSQ:FAIL,TO=%" PRIu8 "\n"), message.getDestination());
+		gatewayQueueRemove(_gatewayBusQueue, next);
+	}
+}
+#endif
+
+// send message from controller to the bus, queued if enabled
+void _gatewayForward(MyMessage &message)
+{
+#if (MY_GATEWAY_BUS_QUEUE_SIZE > 0) && defined(MY_SENSOR_NETWORK)
+	_gatewayBusForward(message);
+#elif defined(MY_SENSOR_NETWORK)
+	(void)transportSendRoute(message);
+#else
+	(void)message;
+#endif
+}
+
+#if (MY_GATEWAY_VALUE_CACHE_SIZE > 0)
+#if (MY_GATEWAY_VALUE_CACHE_SIZE & (MY_GATEWAY_VALUE_CACHE_SIZE - 1)) || (MY_GATEWAY_VALUE_CACHE_SIZE > 256u)
+#error MY_GATEWAY_VALUE_CACHE_SIZE must be a power of 2 and not larger than 256
+#endif
+#define GATEWAY_CACHE_MASK (MY_GATEWAY_VALUE_CACHE_SIZE - 1)
+// linear probing is limited to this many slots, the oldest of them is replaced if all are used
+#define GATEWAY_CACHE_PROBES (MY_GATEWAY_VALUE_CACHE_SIZE < 8u ? MY_GATEWAY_VALUE_CACHE_SIZE : 8u)
+
+gatewayCacheEntry_t _gatewayCache[MY_GATEWAY_VALUE_CACHE_SIZE];	// open addressed, no deletion
+
+// slot of the key, or a free / the oldest slot of the probe window if absent
+uint8_t _gatewayCacheSlot(const uint8_t node, const uint8_t sensor, const uint8_t type, bool &found)
+{
+	const uint32_t nowMs = hwMillis();
+	uint8_t slot = static_cast<uint8_t>((node * 37u) ^ (sensor * 11u) ^ type) & GATEWAY_CACHE_MASK;
+	uint8_t oldest = slot;
+	for (uint8_t probe = 0; probe < GATEWAY_CACHE_PROBES; probe++) {
+		const gatewayCacheEntry_t &entry = _gatewayCache[slot];
+		found = entry.used && entry.node == node && entry.sensor == sensor && entry.type == type;
+		if (!entry.used || found) {
+			return slot;
+		}
+		if (nowMs - entry.receivedMs > nowMs - _gatewayCache[oldest].receivedMs) {
+			oldest = slot;
+		}
+		slot = (slot + 1) & GATEWAY_CACHE_MASK;
+	}
+	return oldest;
+}
+#endif
+
+void gatewayCacheUpdate(const MyMessage &message)
+{
+#if (MY_GATEWAY_VALUE_CACHE_SIZE > 0)
+	// values reported by nodes, and echoes confirming a C_SET of the controller
+	if (message.getCommand() != C_SET) {
+		return;
+	}
+	bool found;
+	gatewayCacheEntry_t &entry = _gatewayCache[_gatewayCacheSlot(message.getSender(),
+	                                           message.getSensor(), message.getType(), found)];
+	entry.receivedMs = hwMillis();
+	entry.used = true;
+	entry.node = message.getSender();
+	entry.sensor = message.getSensor();
+	entry.type = message.getType();
+	entry.payloadType = message.getPayloadType();
+	const uint8_t length = message.getLength();
+	if (length > MY_GATEWAY_VALUE_CACHE_PAYLOAD) {
+		// keep the slot, but an older value must not be served
+		entry.length = GATEWAY_CACHE_UNCACHEABLE;
+		return;
+	}
+	entry.length = length;
+	(void)memcpy(entry.payload, message.data, length);
+#else
+	(void)message;
+#endif
+}
+
+void gatewayCacheInvalidate(const MyMessage &command)
+{
+#if (MY_GATEWAY_VALUE_CACHE_SIZE > 0)
+	if (command.getCommand() != C_SET) {
+		return;
+	}
+	bool found;
+	gatewayCacheEntry_t &entry = _gatewayCache[_gatewayCacheSlot(command.getDestination(),
+	                                           command.getSensor(), command.getType(), found)];
+	if (found) {
+		// value is unknown until the node reports it or echoes the command
+		entry.length = GATEWAY_CACHE_UNCACHEABLE;
+	}
+#else
+	(void)command;
+#endif
+}
+
+bool gatewayCacheAnswer(const MyMessage &request)
+{
+#if (MY_GATEWAY_VALUE_CACHE_SIZE > 0)
+	if (request.getCommand() != C_REQ) {
+		return false;
+	}
+	bool found;
+	const gatewayCacheEntry_t &entry = _gatewayCache[_gatewayCacheSlot(request.getDestination(),
+	                                   request.getSensor(), request.getType(), found)];
+	if (!found || entry.length == GATEWAY_CACHE_UNCACHEABLE) {
+		return false;
+	}
+	const uint32_t ageS = (hwMillis() - entry.receivedMs) / 1000u;
+	GATEWAY_DEBUG(PSTR("GWT:VCA:N=%" PRIu8 ",C=%" PRIu8 ",T=%" PRIu8 ",AGE=%" PRIu32 "\n"), entry.node,
+	              entry.sensor, entry.type, ageS);
+	// reply as if sent by the node
+	_msgTmp.setSender(entry.node);
+	_msgTmp.setDestination(GATEWAY_ADDRESS);
+	_msgTmp.setSensor(entry.sensor);
+	_msgTmp.setType(entry.type);
+	_msgTmp.setCommand(C_SET);
+	_msgTmp.setRequestEcho(false);
+	_msgTmp.setEcho(false);
+	(void)_msgTmp.set(entry.payload, entry.length);
+	(void)_msgTmp.setPayloadType(static_cast<mysensors_payload_t>(entry.payloadType));
+	(void)gatewayTransportSend(_msgTmp);
+	_msgTmp.setCommand(C_INTERNAL);
+	_msgTmp.setType(I_VALUE_AGE);
+	(void)gatewayTransportSend(_msgTmp.set(ageS));
+	return true;
+#else
+	(void)request;
+	return false;
+#endif
+}
+
+#if (MY_GATEWAY_MAILBOX_SIZE > 0) && defined(MY_SENSOR_NETWORK)
+MyMessage _gatewayMailbox[MY_GATEWAY_MAILBOX_SIZE];	// messages held for sleeping nodes, in arrival order
+uint8_t _gatewayMailboxCount = 0;
+uint8_t _gatewayMailboxPeak = 0;
+uint16_t _gatewayMailboxHeld = 0;
+uint16_t _gatewayMailboxDropped = 0;
+uint8_t _gatewaySleeping[32];	// bit per node id, set between I_PRE_ and I_POST_SLEEP_NOTIFICATION
+
+bool _gatewayIsSleeping(const uint8_t node)
+{
+	return _gatewaySleeping[node >> 3] & _BV(node & 0x07);
+}
+
+// remove message from mailbox, keeps arrival order
+void _gatewayMailboxRemove(const uint8_t slot)
+{
+	_gatewayMailboxCount--;
+	for (uint8_t i = slot; i < _gatewayMailboxCount; i++) {
+		_gatewayMailbox[i] = _gatewayMailbox[i + 1];
+	}
+}
+
+// hold message for sleeping destination, returns false if destination is awake
+bool _gatewayMailboxHold(const MyMessage &message)
+{
+	const uint8_t node = message.getDestination();
+	if (!_gatewayIsSleeping(node)) {
+		return false;
+	}
+	if (_gatewayMailboxCount == MY_GATEWAY_MAILBOX_SIZE) {
+		GATEWAY_DEBUG(PSTR("!GWT:MBX:FULL,N=%" PRIu8 "\n"), _gatewayMailbox[0].getDestination());
+		_gatewayMailboxDropped++;
+		_gatewayMailboxRemove(0);
+	}
+	GATEWAY_DEBUG(PSTR("GWT:MBX:HOLD,N=%" PRIu8 "\n"), node);
+	_gatewayMailbox[_gatewayMailboxCount++] = message;
+	_gatewayMailboxHeld++;
+	if (_gatewayMailboxCount > _gatewayMailboxPeak) {
+		_gatewayMailboxPeak = _gatewayMailboxCount;
+	}
+	return true;
+}
+
+// hand over one held message to a node that woke up, paced to one per loop
+void _gatewayMailboxService(void)
+{
+	for (uint8_t slot = 0; slot < _gatewayMailboxCount; slot++) {
+		if (!_gatewayIsSleeping(_gatewayMailbox[slot].getDestination())) {
+			_processActivity();
+			_msgTmp = _gatewayMailbox[slot];
+			_gatewayMailboxRemove(slot);
+			_gatewayForward(_msgTmp);
+			return;
+		}
+	}
+}
+#endif
+
+void gatewayMailboxNotify(const MyMessage &message)
+{
+#if (MY_GATEWAY_MAILBOX_SIZE > 0) && defined(MY_SENSOR_NETWORK)
+	const uint8_t node = message.getSender();
+	if (message.getCommand() == C_INTERNAL && message.getType() == I_PRE_SLEEP_NOTIFICATION) {
+		GATEWAY_DEBUG(PSTR("GWT:MBX:SLEEP,N=%" PRIu8 "\n"), node);
+		_gatewaySleeping[node >> 3] |= _BV(node & 0x07);
+	} else if (_gatewayIsSleeping(node)) {
+		// I_POST_SLEEP_NOTIFICATION, or any other message if that one was lost
+		GATEWAY_DEBUG(PSTR("GWT:MBX:WAKE,N=%" PRIu8 "\n"), node);
+		_gatewaySleeping[node >> 3] &= ~_BV(node & 0x07);
+	}
+#else
+	(void)message;
+#endif
+}
+
+uint8_t gatewayTransportGetBusStatistics(void *data)
+{
+#if ((MY_GATEWAY_BUS_QUEUE_SIZE > 0) || (MY_GATEWAY_MAILBOX_SIZE > 0)) && defined(MY_SENSOR_NETWORK)
+	gatewayBusStats_t stats;
+	(void)memset(&stats, 0, sizeof(stats));
+	stats.version = GATEWAY_STATS_VERSION;
+#if (MY_GATEWAY_BUS_QUEUE_SIZE > 0)
+	stats.depth = _gatewayBusQueue.count;
+	stats.peak = _gatewayBusQueue.peak;
+	stats.size = MY_GATEWAY_BUS_QUEUE_SIZE;
+	stats.queued = _gatewayBusQueue.queued;
+	stats.dropped = _gatewayBusQueue.dropped;
+	stats.retries = _gatewayBusRetries;
+	stats.failed = _gatewayBusFailed;
+	stats.maxWaitMs = _gatewayBusQueue.maxWaitMs;
+#endif
+#if (MY_GATEWAY_MAILBOX_SIZE > 0)
+	stats.mailDepth = _gatewayMailboxCount;
+	stats.mailPeak = _gatewayMailboxPeak;
+	stats.mailHeld = _gatewayMailboxHeld;
+	stats.mailDropped = _gatewayMailboxDropped;
+#endif
+	(void)memcpy(data, &stats, sizeof(stats));
+	return sizeof(stats);
+#else
+	(void)data;
+	return 0;
+#endif
+}
+
+// handle one message from controller, returns false if none available
+bool _gatewayProcessController(void)
+{
+	PROFILE_START(PROFILE_GATEWAY_AVAILABLE);
+	const bool available = gatewayTransportAvailable();
+	PROFILE_END(PROFILE_GATEWAY_AVAILABLE);
+	if (available) {
+		_processActivity();
 		_msg = gatewayTransportReceive();
 		if (_msg.getDestination() == GATEWAY_ADDRESS) {
 
@@ -42,17 +485,27 @@ inline void gatewayTransportProcess(void)
 				_msgTmp.setDestination(_msg.getSender());
 				gatewayTransportSend(_msgTmp);
 			}
+			pendingRequestComplete(_msg);
 			if (_msg.getCommand() == C_INTERNAL) {
 				if (_msg.getType() == I_VERSION) {
-					// Request for version. Create the response
-					gatewayTransportSend(buildGw(_msgTmp, I_VERSION).set(MYSENSORS_LIBRARY_VERSION));
+#if defined(MY_GATEWAY_BINARY_PROTOCOL)
+					if (!strncmp(_msg.data, MSG_GW_BINARY_HANDSHAKE, sizeof(MSG_GW_BINARY_HANDSHAKE))) {
+						// Request for binary protocol, confirm as last text line
+						gatewayTransportSend(buildGw(_msgTmp, I_VERSION).set(MSG_GW_BINARY_HANDSHAKE));
+						gatewayTransportSetBinary(true);
+					} else
+#endif
+					{
+						// Request for version. Create the response
+						gatewayTransportSend(buildGw(_msgTmp, I_VERSION).set(MYSENSORS_LIBRARY_VERSION));
+					}
 #ifdef MY_INCLUSION_MODE_FEATURE
 				} else if (_msg.getType() == I_INCLUSION_MODE) {
 					// Request to change inclusion mode
 					inclusionModeSet(atoi(_msg.data) == 1);
 #endif
 				} else {
-					(void)_processInternalCoreMessage();
+					(void)_processInternalCoreMessage(false);
 				}
 			} else {
 				// Call incoming message callback if available
@@ -61,9 +514,41 @@ inline void gatewayTransportProcess(void)
 				}
 			}
 		} else {
-#if defined(MY_SENSOR_NETWORK)
-			transportSendRoute(_msg);
+#if (MY_GATEWAY_VALUE_CACHE_SIZE > 0)
+			gatewayCacheInvalidate(_msg);
+#endif
+#if (MY_GATEWAY_VALUE_CACHE_SIZE > 0) && !defined(MY_GATEWAY_VALUE_CACHE_FORWARD)
+			if (gatewayCacheAnswer(_msg)) {
+				// node is not asked
+				return true;
+			}
+#elif (MY_GATEWAY_VALUE_CACHE_SIZE > 0)
+			(void)gatewayCacheAnswer(_msg);
+#endif
+#if (MY_GATEWAY_MAILBOX_SIZE > 0) && defined(MY_SENSOR_NETWORK)
+			if (_gatewayMailboxHold(_msg)) {
+				return true;
+			}
 #endif
+			_gatewayForward(_msg);
 		}
 	}
+	return available;
+}
+
+inline void gatewayTransportProcess(void)
+{
+	gatewayTransportDrain();
+#if (MY_GATEWAY_BUS_QUEUE_SIZE > 0) && defined(MY_SENSOR_NETWORK)
+	// absorb a burst from the controller, then send one queued message
+	uint8_t burst = MY_GATEWAY_BUS_QUEUE_SIZE;
+	while (burst-- && _gatewayProcessController()) {
+	}
+	_gatewayBusService();
+#else
+	(void)_gatewayProcessController();
+#endif
+#if (MY_GATEWAY_MAILBOX_SIZE > 0) && defined(MY_SENSOR_NETWORK)
+	_gatewayMailboxService();
+#endif
 }
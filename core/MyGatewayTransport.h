@@ -37,6 +37,11 @@
 *  - GWT:<b>RFC</b>		from _readFromClient()
 *  - GWT:<b>TSA</b>		from @ref gatewayTransportAvailable()
 *  - GWT:<b>TRC</b>		from @ref gatewayTransportReceive()
+*  - GWT:<b>TXQ</b>		from gatewayTransportSend() / @ref gatewayTransportDrain()
+*  - GWT:<b>TSB</b>		from @ref gatewayTransportSetBinary()
+*  - GWT:<b>BSQ</b>		from @ref gatewayTransportProcess(), queue to the bus
+*  - GWT:<b>VCA</b>		from @ref gatewayCacheAnswer()
+*  - GWT:<b>MBX</b>		from @ref gatewayMailboxNotify() / gatewayTransportProcess(), mailbox of sleeping nodes
 *
 * Gateway transport debug log messages :
 *
@@ -66,6 +71,20 @@
 * | | GWT | TSA   | C=%d,CONNECTED            | Client [%%d] connected
 * |!| GWT | TSA   | NO FREE SLOT              | No free slot for client
 * |!| GWT | TRC   | IP RENEW FAIL             | IP renewal failed
+* |!| GWT | TXQ   | FULL                      | TX queue full, next message written blocking
+* |!| GWT | TXQ   | DROP                      | TX queue full, message dropped by policy
+* |!| GWT | BSQ   | FULL                      | Bus queue full, next message sent blocking
+* |!| GWT | BSQ   | DROP                      | Bus queue full, message dropped by policy
+* |!| GWT | BSQ   | RETRY,TO=%%d,N=%%d         | Sending to node (TO) failed, retry (N) after backoff
+* |!| GWT | BSQ   | FAIL,TO=%%d                | Sending to node (TO) failed, retries exhausted, message dropped
+* | | GWT | VCA   | N=%%d,C=%%d,T=%%d,AGE=%%d    | C_REQ for node (N), child (C), type (T) answered from cache, value age in s
+* | | GWT | MBX   | SLEEP,N=%%d                | Node (N) announced sleep, messages to it are held
+* | | GWT | MBX   | WAKE,N=%%d                 | Node (N) is awake, held messages are sent
+* | | GWT | MBX   | HOLD,N=%%d                 | Message to sleeping node (N) held in mailbox
+* |!| GWT | MBX   | FULL,N=%%d                 | Mailbox full, oldest message (to node N) dropped
+* | | GWT | TSB   | BIN=%%d                   | Controller link switched to binary (BIN=1) or text (BIN=0) protocol
+* |!| GWT | TSA   | BIN FRAME ERR,LEN=%%d     | Invalid binary frame of length (LEN) dropped
+* |!| GWT | TSA   | PARSE ERR=%%d,COL=%%d      | Invalid line dropped, protocolParseError_t (ERR) at column (COL)
 *
 * @brief API declaration for MyGatewayTransport
 *
@@ -78,6 +97,101 @@
 #include "MySensorsCore.h"
 
 #define MSG_GW_STARTUP_COMPLETE "Gateway startup complete."		//!< Gateway startup message
+#define MSG_GW_BINARY_HANDSHAKE "BIN1"		//!< I_VERSION payload requesting / confirming the binary protocol
+
+#define GATEWAY_STATS_VERSION (4u)	//!< layout version of gatewayQueueStats_t and gatewayBusStats_t
+
+#define GATEWAY_PRIORITY_COMMAND (0u)		//!< C_SET / C_REQ / I_VALUE_AGE: actuator commands and sensor values
+#define GATEWAY_PRIORITY_INTERNAL (1u)		//!< C_INTERNAL / C_STREAM
+#define GATEWAY_PRIORITY_PRESENTATION (2u)	//!< C_PRESENTATION
+
+#define GATEWAY_QUEUE_BLOCK (0u)		//!< full queue: deliver the next queued message blocking, nothing is lost
+#define GATEWAY_QUEUE_DROP_OLDEST (1u)	//!< full queue: drop the oldest message of the lowest priority class
+#define GATEWAY_QUEUE_DROP_NEWEST (2u)	//!< full queue: drop the newest message of the lowest priority class
+
+#define GATEWAY_QUEUE_NONE (0xFFu)	//!< no queued message ready
+
+#define GATEWAY_CACHE_UNCACHEABLE (0xFFu)	//!< cache entry length: last value too long, requests are forwarded
+
+/**
+ * @brief Last C_SET value of (node, child, type)
+ */
+typedef struct {
+	uint32_t receivedMs;	//!< time the value was received
+	bool used;				//!< slot in use
+	uint8_t node;			//!< sender
+	uint8_t sensor;			//!< child
+	uint8_t type;			//!< variable type
+	uint8_t payloadType;	//!< mysensors_payload_t
+	uint8_t length;			//!< payload length or GATEWAY_CACHE_UNCACHEABLE
+	uint8_t payload[MY_GATEWAY_VALUE_CACHE_PAYLOAD];	//!< payload
+} gatewayCacheEntry_t;
+
+/**
+ * @brief Bookkeeping of a queued message
+ */
+typedef struct {
+	uint16_t queuedMs;	//!< time the message was queued
+	uint16_t dueMs;		//!< earliest time of the next delivery attempt
+	uint8_t priority;	//!< GATEWAY_PRIORITY_*
+	uint8_t seq;		//!< insertion order, older messages first within a priority class
+	uint8_t retries;	//!< failed delivery attempts
+} gatewayQueueEntry_t;
+
+/**
+ * @brief Bounded priority queue of messages, slots 0..count-1 are in use
+ */
+typedef struct {
+	MyMessage *messages;			//!< message storage, size entries
+	gatewayQueueEntry_t *entries;	//!< bookkeeping, size entries
+	uint8_t size;					//!< number of slots
+	uint8_t policy;					//!< GATEWAY_QUEUE_* policy if full
+	uint8_t count;					//!< messages queued
+	uint8_t peak;					//!< highest number of queued messages
+	uint8_t seq;					//!< sequence number of the next message
+	uint16_t queued;				//!< messages that had to be queued
+	uint16_t dropped;				//!< messages dropped by policy
+	uint16_t maxWaitMs;				//!< longest time a message waited in the queue
+} gatewayQueue_t;
+
+/**
+ * @brief Gateway queue and link statistics, sent as binary (little endian) I_DEBUG payload
+ */
+typedef struct {
+	uint8_t version;		//!< GATEWAY_STATS_VERSION
+	uint8_t txDepth;		//!< messages to controller currently queued
+	uint8_t txPeak;			//!< highest number of queued messages to controller
+	uint8_t txSize;			//!< size of queue to controller
+	uint16_t txQueued;		//!< messages to controller that had to be queued
+	uint16_t txStalls;		//!< blocking writes because queue to controller was full
+	uint16_t txMaxWaitMs;	//!< longest time a message to controller waited in the queue
+	uint16_t txLines;		//!< lines written to controller
+	uint16_t txBatches;		//!< drain passes that wrote at least one line
+	uint16_t rxOverruns;	//!< bytes lost in the UART hardware, requires MY_GATEWAY_UART
+	uint16_t rxFrameErrors;	//!< bytes with framing error, requires MY_GATEWAY_UART
+	uint16_t rxDropped;		//!< bytes dropped because the RX ring was full, requires MY_GATEWAY_UART
+	uint16_t txBlocked;		//!< writes waiting for room in the TX ring, requires MY_GATEWAY_UART
+	uint16_t txDropped;		//!< messages to controller dropped by MY_GATEWAY_TX_QUEUE_POLICY
+} __attribute__((packed)) gatewayQueueStats_t;
+
+/**
+ * @brief Statistics of the queue from controller to the bus, sent as binary (little endian) I_DEBUG payload
+ */
+typedef struct {
+	uint8_t version;		//!< GATEWAY_STATS_VERSION
+	uint8_t depth;			//!< messages currently queued
+	uint8_t peak;			//!< highest number of queued messages
+	uint8_t size;			//!< size of queue
+	uint16_t queued;		//!< messages queued
+	uint16_t dropped;		//!< messages dropped by MY_GATEWAY_BUS_QUEUE_POLICY
+	uint16_t retries;		//!< failed sends that were retried
+	uint16_t failed;		//!< messages dropped after MY_GATEWAY_BUS_RETRIES
+	uint16_t maxWaitMs;		//!< longest time a message waited in the queue
+	uint8_t mailDepth;		//!< messages held for sleeping nodes
+	uint8_t mailPeak;		//!< highest number of held messages
+	uint16_t mailHeld;		//!< messages held for sleeping nodes
+	uint16_t mailDropped;	//!< held messages dropped because the mailbox was full
+} __attribute__((packed)) gatewayBusStats_t;
 
 #if defined(MY_DEBUG_VERBOSE_GATEWAY)
 #define GATEWAY_DEBUG(x,...)	DEBUG_OUTPUT(x, ##__VA_ARGS__)	//!< debug output
@@ -90,6 +204,78 @@
  */
 void gatewayTransportProcess(void);
 
+/**
+ * @brief Check for I_VALUE_AGE, which belongs to the C_SET sent directly before it
+ * @param message
+ * @return true if I_VALUE_AGE
+ */
+bool gatewayIsValueAge(const MyMessage &message);
+
+/**
+ * @brief Priority class of a message in the gateway queues
+ * @param message
+ * @return GATEWAY_PRIORITY_*
+ */
+uint8_t gatewayMessagePriority(const MyMessage &message);
+
+/**
+ * @brief Queue message, applies the queue policy if full
+ *
+ * With @ref GATEWAY_QUEUE_BLOCK the caller has to make room before. I_VALUE_AGE is never dropped on its own,
+ * the caller has to make room for it as well if its C_SET is not queued any more.
+ * @param queue
+ * @param message
+ * @return false if a message (queued or new one) was dropped
+ */
+bool gatewayQueuePush(gatewayQueue_t &queue, const MyMessage &message);
+
+/**
+ * @brief Find next message to deliver: highest priority class, oldest first
+ * @param queue
+ * @param dueOnly skip messages waiting for a retry backoff
+ * @return slot or GATEWAY_QUEUE_NONE
+ */
+uint8_t gatewayQueueNext(const gatewayQueue_t &queue, const bool dueOnly);
+
+/**
+ * @brief Remove message from queue, accounts its waiting time
+ * @param queue
+ * @param slot
+ */
+void gatewayQueueRemove(gatewayQueue_t &queue, const uint8_t slot);
+
+/**
+ * @brief Store C_SET value received from the bus in the value cache, see @ref MY_GATEWAY_VALUE_CACHE_SIZE
+ * @param message C_SET of a node, or echo of a C_SET sent by the controller
+ */
+void gatewayCacheUpdate(const MyMessage &message);
+
+/**
+ * @brief Invalidate the cached value a C_SET from the controller is about to change
+ * @param command
+ */
+void gatewayCacheInvalidate(const MyMessage &command);
+
+/**
+ * @brief Answer C_REQ from the value cache: C_SET with the cached value, followed by I_VALUE_AGE
+ * @param request
+ * @return true if answered
+ */
+bool gatewayCacheAnswer(const MyMessage &request);
+
+/**
+ * @brief Track sleep state of nodes for the mailbox, see @ref MY_GATEWAY_MAILBOX_SIZE
+ * @param message received from the bus
+ */
+void gatewayMailboxNotify(const MyMessage &message);
+
+/**
+ * @brief Copy statistics block of the queue from controller to the bus
+ * @param data buffer, at least MAX_PAYLOAD_SIZE bytes
+ * @return length of statistics block, 0 if not available
+ */
+uint8_t gatewayTransportGetBusStatistics(void *data);
+
 /**
  * @brief Initialize gateway transport driver
  * @return true if transport initialized
@@ -103,6 +289,24 @@ bool gatewayTransportInit(void);
  */
 bool gatewayTransportSend(MyMessage &message);
 
+/**
+ * @brief Write queued messages to controller as far as the link accepts them without blocking
+ */
+void gatewayTransportDrain(void);
+
+/**
+ * @brief Switch controller link between text and binary protocol, see @ref MY_GATEWAY_BINARY_PROTOCOL
+ * @param binary true for binary frames
+ */
+void gatewayTransportSetBinary(const bool binary);
+
+/**
+ * @brief Copy gateway queue and link statistics block
+ * @param data buffer, at least MAX_PAYLOAD_SIZE bytes
+ * @return length of statistics block, 0 if not available
+ */
+uint8_t gatewayTransportGetStatistics(void *data);
+
 /**
  * @brief Check if a new message is available from controller
  * @return true if message available
@@ -25,20 +25,163 @@
 
 // global variables
 extern MyMessage _msgTmp;
+extern char _fmtBuffer[MY_GATEWAY_MAX_SEND_LENGTH];
 
-char _serialInputString[MY_GATEWAY_MAX_RECEIVE_LENGTH];    // A buffer for incoming commands from serial interface
-uint8_t _serialInputPos;
+protocolParser_t _serialParser;	// incoming commands are parsed while received, no line buffer
 MyMessage _serialMsg;
 
+#if defined(MY_GATEWAY_BINARY_PROTOCOL)
+bool _serialBinary = false;	// binary frames instead of text lines, negotiated by controller
+uint8_t _serialFrame[PROTOCOL_BINARY_MAX_FRAME];	// incoming binary frame
+uint8_t _serialFramePos;
+bool _serialTextLine = true;	// current line may be text, started after a delimiter or an idle link
+uint32_t _serialRxMs;	// last byte received
+#endif
+
+// format message into _fmtBuffer, returns length
+uint8_t _serialFormat(const MyMessage &message)
+{
+#if defined(MY_GATEWAY_BINARY_PROTOCOL)
+	if (_serialBinary) {
+		return protocolMyMessage2Binary(message, reinterpret_cast<uint8_t *>(_fmtBuffer));
+	}
+#endif
+	return protocolFormatSerial(message, _fmtBuffer);
+}
+
+// write formatted message, blocks if TX buffer is full
+void _serialPrint(const MyMessage &message)
+{
+	const uint8_t length = _serialFormat(message);
+	(void)MY_SERIALDEVICE.write(reinterpret_cast<const uint8_t *>(_fmtBuffer), length);
+}
+
+#if (MY_GATEWAY_TX_QUEUE_SIZE > 0) || defined(MY_GATEWAY_UART)
+gatewayQueueStats_t _serialTxStats;
+#endif
+
+#if (MY_GATEWAY_TX_QUEUE_SIZE > 0)
+MyMessage _serialTxMessages[MY_GATEWAY_TX_QUEUE_SIZE];	// messages waiting for room in the serial TX buffer
+gatewayQueueEntry_t _serialTxEntries[MY_GATEWAY_TX_QUEUE_SIZE];
+gatewayQueue_t _serialTxQueue = { _serialTxMessages, _serialTxEntries, MY_GATEWAY_TX_QUEUE_SIZE, MY_GATEWAY_TX_QUEUE_POLICY, 0, 0, 0, 0, 0, 0 };
+int _serialTxRoom = 0;	// largest free TX buffer space seen, i.e. size of the empty buffer
+
+// write the whole line if it fits into the TX buffer, lines longer than the buffer are written to an empty buffer
+bool _serialWriteLine(const MyMessage &message)
+{
+	const int room = MY_SERIALDEVICE.availableForWrite();
+	if (room > _serialTxRoom) {
+		_serialTxRoom = room;
+	}
+	const uint8_t length = _serialFormat(message);
+	if (room < _serialTxRoom && room < length) {
+		return false;
+	}
+	(void)MY_SERIALDEVICE.write(reinterpret_cast<const uint8_t *>(_fmtBuffer), length);
+	_serialTxStats.txLines++;
+	return true;
+}
+
+// write next queued message blocking
+void _serialTxFlushOne(void)
+{
+	const uint8_t next = gatewayQueueNext(_serialTxQueue, false);
+	_serialPrint(_serialTxQueue.messages[next]);
+	_serialTxStats.txLines++;
+	gatewayQueueRemove(_serialTxQueue, next);
+}
+#endif
+
 // cppcheck-suppress constParameter
 bool gatewayTransportSend(MyMessage &message)
 {
 	setIndication(INDICATION_GW_TX);
-	MY_SERIALDEVICE.print(protocolMyMessage2Serial(message));
+#if (MY_GATEWAY_TX_QUEUE_SIZE > 0)
+	// only write directly if nothing is queued, queued messages are written by priority
+	if (_serialTxQueue.count || !_serialWriteLine(message)) {
+		// an age is not dropped, its value may be written already
+		if (_serialTxQueue.count == MY_GATEWAY_TX_QUEUE_SIZE &&
+		        (MY_GATEWAY_TX_QUEUE_POLICY == GATEWAY_QUEUE_BLOCK || gatewayIsValueAge(message))) {
+			GATEWAY_DEBUG(PSTR("!GWT:TXQ:FULL\n"));
+			_serialTxStats.txStalls++;
+			_serialTxFlushOne();
+		}
+		if (!gatewayQueuePush(_serialTxQueue, message)) {
+			GATEWAY_DEBUG(PSTR("!GWT:TXQ:DROP\n"));
+		}
+	}
+#else
+	_serialPrint(message);
+#endif
 	// Serial print is always successful
 	return true;
 }
 
+void gatewayTransportDrain(void)
+{
+#if (MY_GATEWAY_TX_QUEUE_SIZE > 0)
+	// write as many lines as fit in one pass
+	const uint8_t queued = _serialTxQueue.count;
+	while (_serialTxQueue.count) {
+		const uint8_t next = gatewayQueueNext(_serialTxQueue, false);
+		if (!_serialWriteLine(_serialTxQueue.messages[next])) {
+			break;
+		}
+		gatewayQueueRemove(_serialTxQueue, next);
+	}
+	if (_serialTxQueue.count != queued) {
+		_serialTxStats.txBatches++;
+	}
+#endif
+}
+
+void gatewayTransportSetBinary(const bool binary)
+{
+#if defined(MY_GATEWAY_BINARY_PROTOCOL)
+#if (MY_GATEWAY_TX_QUEUE_SIZE > 0)
+	// queued messages were sent before the switch, write them in the old format
+	while (_serialTxQueue.count) {
+		_serialTxFlushOne();
+	}
+#endif
+	GATEWAY_DEBUG(PSTR("GWT:TSB:BIN=%" PRIu8 "\n"), binary);
+	_serialBinary = binary;
+	_serialFramePos = 0;
+	_serialTextLine = true;
+	(void)memset(&_serialParser, 0, sizeof(_serialParser));
+#else
+	(void)binary;
+#endif
+}
+
+uint8_t gatewayTransportGetStatistics(void *data)
+{
+#if (MY_GATEWAY_TX_QUEUE_SIZE > 0) || defined(MY_GATEWAY_UART)
+	_serialTxStats.version = GATEWAY_STATS_VERSION;
+#if (MY_GATEWAY_TX_QUEUE_SIZE > 0)
+	_serialTxStats.txDepth = _serialTxQueue.count;
+	_serialTxStats.txPeak = _serialTxQueue.peak;
+	_serialTxStats.txSize = MY_GATEWAY_TX_QUEUE_SIZE;
+	_serialTxStats.txQueued = _serialTxQueue.queued;
+	_serialTxStats.txMaxWaitMs = _serialTxQueue.maxWaitMs;
+	_serialTxStats.txDropped = _serialTxQueue.dropped;
+#endif
+#if defined(MY_GATEWAY_UART)
+	gatewayUARTStats_t link;
+	GatewaySerial.getStatistics(link);
+	_serialTxStats.rxOverruns = link.rxOverruns;
+	_serialTxStats.rxFrameErrors = link.rxFrameErrors;
+	_serialTxStats.rxDropped = link.rxDropped;
+	_serialTxStats.txBlocked = link.txBlocked;
+#endif
+	(void)memcpy(data, &_serialTxStats, sizeof(_serialTxStats));
+	return sizeof(_serialTxStats);
+#else
+	(void)data;
+	return 0;
+#endif
+}
+
 bool gatewayTransportInit(void)
 {
 	(void)gatewayTransportSend(buildGw(_msgTmp, I_GATEWAY_READY).set(MSG_GW_STARTUP_COMPLETE));
@@ -47,30 +190,81 @@ bool gatewayTransportInit(void)
 	return true;
 }
 
-bool gatewayTransportAvailable(void)
+#if defined(MY_GATEWAY_BINARY_PROTOCOL)
+// collect a frame until delimiter, a text I_VERSION line (restarted controller) switches back to text
+bool _serialAvailableBinary(void)
 {
 	while (MY_SERIALDEVICE.available()) {
-		// get the new byte:
-		const char inChar = (char)MY_SERIALDEVICE.read();
-		// if the incoming character is a newline, set a flag
-		// so the main loop can do something about it:
-		if (_serialInputPos < MY_GATEWAY_MAX_RECEIVE_LENGTH - 1) {
-			if (inChar == '\n') {
-				_serialInputString[_serialInputPos] = 0;
-				const bool ok = protocolSerial2MyMessage(_serialMsg, _serialInputString);
-				if (ok) {
+		const uint8_t inByte = (uint8_t)MY_SERIALDEVICE.read();
+		const uint32_t nowMs = hwMillis();
+		if (nowMs - _serialRxMs >= MY_GATEWAY_BINARY_IDLE_MS) {
+			// idle link, a text line may start
+			_serialTextLine = true;
+			(void)memset(&_serialParser, 0, sizeof(_serialParser));
+		}
+		_serialRxMs = nowMs;
+		if (inByte == 0x00) {
+			const uint8_t length = _serialFramePos;
+			_serialFramePos = 0;
+			// text lines contain no delimiter
+			_serialTextLine = true;
+			(void)memset(&_serialParser, 0, sizeof(_serialParser));
+			if (length == 0) {
+				// leading delimiter
+				continue;
+			}
+			if (length < sizeof(_serialFrame) && protocolBinary2MyMessage(_serialMsg, _serialFrame, length)) {
+				setIndication(INDICATION_GW_RX);
+				return true;
+			}
+			GATEWAY_DEBUG(PSTR("!GWT:TSA:BIN FRAME ERR,LEN=%" PRIu8 "\n"), length);
+		} else {
+			if (inByte < 0x20 && inByte != '\r' && inByte != '\n') {
+				// control characters are frame contents only
+				_serialTextLine = false;
+			}
+			if (_serialTextLine) {
+				const protocolParseResult_t result = protocolParseChar(_serialParser, _serialMsg, (char)inByte);
+				if (result != PROTOCOL_PARSE_BUSY) {
+					// a following line is frame contents unless it starts after a delimiter or idle link
+					_serialTextLine = false;
+				}
+				if (result == PROTOCOL_PARSE_DONE && _serialMsg.getCommand() == C_INTERNAL &&
+				        _serialMsg.getType() == I_VERSION) {
+					gatewayTransportSetBinary(false);
 					setIndication(INDICATION_GW_RX);
+					return true;
 				}
-				_serialInputPos = 0;
-				return ok;
-			} else {
-				// add it to the inputString:
-				_serialInputString[_serialInputPos] = inChar;
-				_serialInputPos++;
 			}
-		} else {
-			// Incoming message too long. Throw away
-			_serialInputPos = 0;
+			if (_serialFramePos < sizeof(_serialFrame)) {
+				// a frame filling the buffer is too long and dropped at the delimiter
+				_serialFrame[_serialFramePos++] = inByte;
+			}
+		}
+	}
+	return false;
+}
+#endif
+
+bool gatewayTransportAvailable(void)
+{
+#if defined(MY_GATEWAY_BINARY_PROTOCOL)
+	if (_serialBinary) {
+		return _serialAvailableBinary();
+	}
+#endif
+	while (MY_SERIALDEVICE.available()) {
+		// message is built field by field, complete at newline
+		const protocolParseResult_t result = protocolParseChar(_serialParser, _serialMsg,
+		                                     (char)MY_SERIALDEVICE.read());
+		if (result == PROTOCOL_PARSE_DONE) {
+			setIndication(INDICATION_GW_RX);
+			return true;
+		}
+		if (result == PROTOCOL_PARSE_ERROR) {
+			GATEWAY_DEBUG(PSTR("!GWT:TSA:PARSE ERR=%" PRIu8 ",COL=%" PRIu8 "\n"), _serialParser.error,
+			              _serialParser.errorColumn);
+			return false;
 		}
 	}
 	return false;
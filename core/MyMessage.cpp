@@ -253,11 +253,13 @@ const char* MyMessage::getString(void) const
 char* MyMessage::getCustomString(char *buffer) const
 {
 	if (buffer != NULL) {
-		for (uint8_t i = 0; i < this->getLength(); i++) {
-			buffer[i * 2] = convertI2H(this->data[i] >> 4);
-			buffer[(i * 2) + 1] = convertI2H(this->data[i]);
+		const uint8_t length = this->getLength();
+		char *p = buffer;
+		for (uint8_t i = 0; i < length; i++) {
+			*p++ = convertI2H(this->data[i] >> 4);
+			*p++ = convertI2H(this->data[i]);
 		}
-		buffer[this->getLength() * 2] = '\0';
+		*p = '\0';
 		return buffer;
 	} else {
 		return NULL;
@@ -281,8 +283,9 @@ char* MyMessage::getString(char *buffer) const
 	if (buffer != NULL) {
 		const uint8_t payloadType = this->getPayloadType();
 		if (payloadType == P_STRING) {
-			(void)strncpy(buffer, this->data, this->getLength());
-			buffer[this->getLength()] = 0;
+			const uint8_t length = this->getLength();
+			(void)memcpy(buffer, this->data, length);
+			buffer[length] = 0;
 		} else if (payloadType == P_BYTE) {
 			(void)itoa(bValue, buffer, 10);
 		} else if (payloadType == P_INT16) {
@@ -388,9 +391,10 @@ MyMessage& MyMessage::set(const char* value)
 {
 	(void)this->setLength((value != NULL) ? strlen(value) : 0);
 	(void)this->setPayloadType(P_STRING);
-	(void)strncpy(this->data, value, this->getLength());
+	const uint8_t length = this->getLength();
+	(void)memcpy(this->data, value, length);
 	// null terminate string
-	this->data[this->getLength()] = 0;
+	this->data[length] = 0;
 	return *this;
 }
 
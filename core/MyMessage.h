@@ -221,7 +221,8 @@ typedef enum {
 	I_SIGNAL_REPORT_REVERSE		= 30,	//!< Internal
 	I_SIGNAL_REPORT_RESPONSE	= 31,	//!< Device signal strength response (RSSI)
 	I_PRE_SLEEP_NOTIFICATION	= 32,	//!< Message sent before node is going to sleep
-	I_POST_SLEEP_NOTIFICATION	= 33	//!< Message sent after node woke up (if enabled)
+	I_POST_SLEEP_NOTIFICATION	= 33,	//!< Message sent after node woke up (if enabled)
+	I_VALUE_AGE					= 34	//!< Age (in s) of the preceding C_SET value (gateway value cache, node outbox), 0xFFFFFFFF: unknown
 } mysensors_internal_t;
 
 /// @brief Type of data stream (for streamed message)
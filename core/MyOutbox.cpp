@@ -0,0 +1,245 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include "MyOutbox.h"
+
+#if defined(MY_OUTBOX_FEATURE)
+// global variables
+extern MyMessage _msgTmp;
+
+outboxEntry_t _outboxRam[MY_OUTBOX_SIZE];	// newest readings, oldest at _outboxRamHead
+uint8_t _outboxRamHead = 0;
+uint8_t _outboxRamCount = 0;
+uint32_t _outboxSleptMs = 0;
+uint32_t _outboxLastDrainMs = 0;
+outboxStats_t _outboxStats;
+
+#if (MY_OUTBOX_EEPROM_SIZE > 0)
+// older readings, persistent across reboots
+#define OUTBOX_EEPROM_ENTRY(__index) (MY_OUTBOX_EEPROM_ADDRESS + sizeof(outboxEepromHeader_t) + \
+		(__index) * sizeof(outboxEntry_t))
+
+#if defined(E2END)
+static_assert(MY_OUTBOX_EEPROM_ADDRESS + sizeof(outboxEepromHeader_t) +
+              MY_OUTBOX_EEPROM_SIZE * sizeof(outboxEntry_t) <= E2END + 1ul,
+              "Outbox EEPROM ring exceeds the EEPROM, lower MY_OUTBOX_EEPROM_SIZE or MY_OUTBOX_EEPROM_ADDRESS");
+#endif
+
+outboxEepromHeader_t _outboxEeprom;
+bool _outboxLoaded = false;
+uint8_t _outboxPreviousBoot = 0;	// oldest EEPROM readings captured before this boot, age unknown
+
+void _outboxSaveHeader(void)
+{
+	hwWriteConfigBlock((void *)&_outboxEeprom, (void *)MY_OUTBOX_EEPROM_ADDRESS,
+	                   sizeof(outboxEepromHeader_t));
+}
+
+// read ring header on first use, readings from before a reboot are sent as well
+void _outboxLoad(void)
+{
+	if (_outboxLoaded) {
+		return;
+	}
+	_outboxLoaded = true;
+	hwReadConfigBlock((void *)&_outboxEeprom, (void *)MY_OUTBOX_EEPROM_ADDRESS,
+	                  sizeof(outboxEepromHeader_t));
+	if (_outboxEeprom.magic != OUTBOX_EEPROM_MAGIC || _outboxEeprom.head >= MY_OUTBOX_EEPROM_SIZE ||
+	        _outboxEeprom.count > MY_OUTBOX_EEPROM_SIZE) {
+		OUTBOX_DEBUG(PSTR("!OBX:LOD:RESET\n"));
+		_outboxEeprom.magic = OUTBOX_EEPROM_MAGIC;
+		_outboxEeprom.head = 0;
+		_outboxEeprom.count = 0;
+		_outboxSaveHeader();
+	}
+	_outboxPreviousBoot = _outboxEeprom.count;
+}
+
+// move oldest RAM reading to the EEPROM ring, drops the oldest EEPROM reading if full
+void _outboxSpill(const outboxEntry_t &entry)
+{
+	if (_outboxEeprom.count == MY_OUTBOX_EEPROM_SIZE) {
+		OUTBOX_DEBUG(PSTR("!OBX:PSH:DROP\n"));
+		_outboxStats.dropped++;
+		_outboxEeprom.head = (_outboxEeprom.head + 1) % MY_OUTBOX_EEPROM_SIZE;
+		_outboxEeprom.count--;
+		if (_outboxPreviousBoot) {
+			_outboxPreviousBoot--;
+		}
+	}
+	const uint8_t tail = (_outboxEeprom.head + _outboxEeprom.count) % MY_OUTBOX_EEPROM_SIZE;
+	hwWriteConfigBlock((void *)&entry, (void *)OUTBOX_EEPROM_ENTRY(tail), sizeof(outboxEntry_t));
+	_outboxEeprom.count++;
+	_outboxSaveHeader();
+	_outboxStats.spilled++;
+}
+#else
+#define _outboxLoad()
+#endif
+#endif
+
+uint32_t outboxClock(void)
+{
+#if defined(MY_OUTBOX_FEATURE)
+	return hwMillis() + _outboxSleptMs;
+#else
+	return hwMillis();
+#endif
+}
+
+void outboxSlept(const uint32_t sleptMs)
+{
+#if defined(MY_OUTBOX_FEATURE)
+	_outboxSleptMs += sleptMs;
+#else
+	(void)sleptMs;
+#endif
+}
+
+#if defined(MY_OUTBOX_FEATURE)
+// readings only, late protocol messages are meaningless
+bool _outboxIsReading(const MyMessage &message)
+{
+	return message.getCommand() == C_SET && message.getDestination() == GATEWAY_ADDRESS;
+}
+#endif
+
+bool outboxDefer(const MyMessage &message)
+{
+#if defined(MY_OUTBOX_FEATURE)
+	if (!_outboxIsReading(message)) {
+		return false;
+	}
+	_outboxLoad();
+	bool pending = _outboxRamCount;
+#if (MY_OUTBOX_EEPROM_SIZE > 0)
+	pending |= (_outboxEeprom.count > 0);
+#endif
+	if (!pending) {
+		return false;
+	}
+	// sent after the stored readings, a controller unaware of I_VALUE_AGE keeps the newest value
+	outboxPush(message);
+	return true;
+#else
+	(void)message;
+	return false;
+#endif
+}
+
+void outboxPush(const MyMessage &message)
+{
+#if defined(MY_OUTBOX_FEATURE)
+	if (!_outboxIsReading(message)) {
+		return;
+	}
+	_outboxLoad();
+	if (_outboxRamCount == MY_OUTBOX_SIZE) {
+#if (MY_OUTBOX_EEPROM_SIZE > 0)
+		_outboxSpill(_outboxRam[_outboxRamHead]);
+#else
+		OUTBOX_DEBUG(PSTR("!OBX:PSH:DROP\n"));
+		_outboxStats.dropped++;
+#endif
+		_outboxRamHead = (_outboxRamHead + 1) % MY_OUTBOX_SIZE;
+		_outboxRamCount--;
+	}
+	outboxEntry_t &entry = _outboxRam[(_outboxRamHead + _outboxRamCount) % MY_OUTBOX_SIZE];
+	entry.capturedMs = outboxClock();
+	entry.message = message;
+	_outboxRamCount++;
+	_outboxStats.stored++;
+	OUTBOX_DEBUG(PSTR("OBX:PSH:C=%" PRIu8 ",T=%" PRIu8 ",N=%" PRIu8 "\n"), message.getSensor(),
+	           message.getType(), _outboxRamCount);
+#else
+	(void)message;
+#endif
+}
+
+void outboxProcess(void)
+{
+#if defined(MY_OUTBOX_FEATURE)
+	if (!isTransportReady() || hwMillis() - _outboxLastDrainMs < MY_OUTBOX_DRAIN_INTERVAL_MS) {
+		return;
+	}
+	_outboxLoad();
+	outboxEntry_t entry;
+	bool fromEeprom = false;
+#if (MY_OUTBOX_EEPROM_SIZE > 0)
+	// EEPROM holds the older readings
+	fromEeprom = _outboxEeprom.count;
+	if (fromEeprom) {
+		hwReadConfigBlock((void *)&entry, (void *)OUTBOX_EEPROM_ENTRY(_outboxEeprom.head),
+		                  sizeof(outboxEntry_t));
+	}
+#endif
+	if (!fromEeprom) {
+		if (!_outboxRamCount) {
+			return;
+		}
+		entry = _outboxRam[_outboxRamHead];
+	}
+	_outboxLastDrainMs = hwMillis();
+	if (!transportSendRoute(entry.message)) {
+		// keep, next attempt after drain interval
+		return;
+	}
+	uint32_t ageS = (outboxClock() - entry.capturedMs) / 1000u;
+#if (MY_OUTBOX_EEPROM_SIZE > 0)
+	if (fromEeprom && _outboxPreviousBoot) {
+		// capturedMs refers to the clock of a previous boot
+		ageS = OUTBOX_AGE_UNKNOWN;
+	}
+#endif
+	OUTBOX_DEBUG(PSTR("OBX:DRN:C=%" PRIu8 ",AGE=%" PRIu32 "\n"), entry.message.getSensor(), ageS);
+	(void)transportSendRoute(build(_msgTmp, GATEWAY_ADDRESS, entry.message.getSensor(), C_INTERNAL,
+	                               I_VALUE_AGE).set(ageS));
+	_outboxStats.drained++;
+#if (MY_OUTBOX_EEPROM_SIZE > 0)
+	if (fromEeprom) {
+		_outboxEeprom.head = (_outboxEeprom.head + 1) % MY_OUTBOX_EEPROM_SIZE;
+		_outboxEeprom.count--;
+		if (_outboxPreviousBoot) {
+			_outboxPreviousBoot--;
+		}
+		_outboxSaveHeader();
+		return;
+	}
+#endif
+	_outboxRamHead = (_outboxRamHead + 1) % MY_OUTBOX_SIZE;
+	_outboxRamCount--;
+#endif
+}
+
+uint8_t outboxGetStatistics(void *data)
+{
+#if defined(MY_OUTBOX_FEATURE)
+	_outboxLoad();
+	_outboxStats.version = OUTBOX_VERSION;
+	_outboxStats.ramCount = _outboxRamCount;
+#if (MY_OUTBOX_EEPROM_SIZE > 0)
+	_outboxStats.eepromCount = _outboxEeprom.count;
+#endif
+	(void)memcpy(data, &_outboxStats, sizeof(_outboxStats));
+	return sizeof(_outboxStats);
+#else
+	(void)data;
+	return 0;
+#endif
+}
@@ -0,0 +1,125 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/**
+ * @file MyOutbox.h
+ *
+ * Store-and-forward of readings (C_SET to the gateway) that could not be sent, enabled with
+ * @ref MY_OUTBOX_SIZE. Readings are kept in RAM, the oldest ones spill to a ring in EEPROM
+ * (@ref MY_OUTBOX_EEPROM_SIZE), and are sent at @ref MY_OUTBOX_DRAIN_INTERVAL_MS once the
+ * transport is ready again, each followed by I_VALUE_AGE with the age of the reading. New readings
+ * are stored behind them until the outbox is empty, so readings always leave in capture order. The
+ * clock restarts with a reboot, readings stored before are sent with age OUTBOX_AGE_UNKNOWN.
+ *
+ * Outbox log messages, format: [!]SYSTEM:[SUB SYSTEM:]MESSAGE
+ *
+ * |E| SYS | SUB | Message                   | Comment
+ * |-|-----|-----|---------------------------|---------------------------------------------------------------
+ * | | OBX | PSH | C=%%d,T=%%d,N=%%d          | Reading of child (C), type (T) stored, readings in outbox (N)
+ * |!| OBX | PSH | DROP                      | Outbox full, oldest reading dropped
+ * | | OBX | DRN | C=%%d,AGE=%%d              | Stored reading of child (C) sent, age in s (AGE)
+ * |!| OBX | LOD | RESET                     | EEPROM ring header invalid, ring cleared
+ */
+
+#ifndef MyOutbox_h
+#define MyOutbox_h
+
+#if (MY_OUTBOX_SIZE > 0) && defined(MY_SENSOR_NETWORK) && !defined(MY_GATEWAY_FEATURE)
+#define MY_OUTBOX_FEATURE	//!< outbox active, only on nodes
+#endif
+
+#if defined(MY_DEBUG_VERBOSE_CORE)
+#define OUTBOX_DEBUG(x,...)	DEBUG_OUTPUT(x, ##__VA_ARGS__)	//!< debug output
+#else
+#define OUTBOX_DEBUG(x,...)									//!< debug NULL
+#endif
+
+#define OUTBOX_VERSION (1u)		//!< layout version of outboxStats_t
+#define OUTBOX_EEPROM_MAGIC (0x4Fu)	//!< marks a valid EEPROM ring header
+#define OUTBOX_AGE_UNKNOWN (0xFFFFFFFFul)	//!< I_VALUE_AGE of readings stored before the last reboot
+
+/**
+ * @brief Stored reading
+ */
+typedef struct {
+	uint32_t capturedMs;	//!< outboxClock() when the send failed
+	MyMessage message;		//!< reading
+} __attribute__((packed)) outboxEntry_t;
+
+/**
+ * @brief Header of the EEPROM ring, followed by @ref MY_OUTBOX_EEPROM_SIZE entries
+ */
+typedef struct {
+	uint8_t magic;	//!< OUTBOX_EEPROM_MAGIC
+	uint8_t head;	//!< oldest entry
+	uint8_t count;	//!< entries in ring
+} __attribute__((packed)) outboxEepromHeader_t;
+
+/**
+ * @brief Outbox statistics, sent as binary (little endian) I_DEBUG payload
+ */
+typedef struct {
+	uint8_t version;		//!< OUTBOX_VERSION
+	uint8_t ramCount;		//!< readings in RAM
+	uint8_t eepromCount;	//!< readings in EEPROM
+	uint8_t reserved;		//!< reserved
+	uint16_t stored;		//!< readings stored after failed send
+	uint16_t spilled;		//!< readings moved from RAM to EEPROM
+	uint16_t drained;		//!< stored readings sent
+	uint16_t dropped;		//!< readings dropped, outbox full
+} __attribute__((packed)) outboxStats_t;
+
+/**
+ * @brief Store reading instead of sending it while older readings are stored, keeps the capture order
+ * @param message
+ * @return true if stored, false if the message is to be sent now
+ */
+bool outboxDefer(const MyMessage &message);
+
+/**
+ * @brief Store reading whose send failed, other messages are ignored
+ * @param message
+ */
+void outboxPush(const MyMessage &message);
+
+/**
+ * @brief Send the oldest stored reading if transport is ready and the drain interval elapsed
+ */
+void outboxProcess(void);
+
+/**
+ * @brief Account time spent in sleep, millis() does not advance while sleeping
+ * @param sleptMs
+ */
+void outboxSlept(const uint32_t sleptMs);
+
+/**
+ * @brief Time base of capture timestamps: millis() plus time slept
+ * @return ms
+ */
+uint32_t outboxClock(void);
+
+/**
+ * @brief Copy outbox statistics block
+ * @param data buffer, at least MAX_PAYLOAD_SIZE bytes
+ * @return length of statistics block, 0 if outbox disabled
+ */
+uint8_t outboxGetStatistics(void *data);
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include "MyPendingRequest.h"
+
+// global variables
+extern MyMessage _msg;
+
+pendingRequest_t _pendingRequests[PENDING_TABLE_SIZE];	// asynchronous requests first, then waits
+
+uint8_t pendingRequestAdd(const uint8_t sender, const uint8_t sensor, const uint8_t command,
+                          const uint8_t type, const uint32_t timeoutMs, const requestCallback_t callback)
+{
+	const uint8_t first = callback ? 0 : MY_PENDING_REQUESTS;
+	const uint8_t last = callback ? MY_PENDING_REQUESTS : PENDING_TABLE_SIZE;
+	for (uint8_t handle = first; handle < last; handle++) {
+		pendingRequest_t &request = _pendingRequests[handle];
+		if (request.state == PENDING_FREE) {
+			request.deadlineMs = hwMillis() + timeoutMs;
+			request.callback = callback;
+			request.sender = sender;
+			request.sensor = sensor;
+			request.command = command;
+			request.type = type;
+			request.state = PENDING_WAITING;
+			return handle;
+		}
+	}
+	PENDING_DEBUG(PSTR("!PRQ:ADD:FULL\n"));
+	return PENDING_REQUEST_NONE;
+}
+
+uint8_t pendingRequestWait(const uint8_t command, const uint8_t type, const uint32_t timeoutMs)
+{
+	const uint8_t handle = pendingRequestAdd(PENDING_ANY, PENDING_ANY, command, type, timeoutMs, NULL);
+	if (handle == PENDING_REQUEST_NONE) {
+		// invalidate, pendingRequestPoll() checks the last received message instead
+		_msg.setCommand(C_INVALID_7);
+	}
+	return handle;
+}
+
+bool pendingRequestPoll(const uint8_t handle, const uint8_t command, const uint8_t type)
+{
+	if (handle == PENDING_REQUEST_NONE) {
+		return _msg.getCommand() == command && (type == PENDING_ANY || _msg.getType() == type);
+	}
+	return pendingRequestDone(handle);
+}
+
+bool pendingRequestRelease(const uint8_t handle)
+{
+	if (handle >= PENDING_TABLE_SIZE) {
+		return false;
+	}
+	const bool done = (_pendingRequests[handle].state == PENDING_DONE);
+	_pendingRequests[handle].state = PENDING_FREE;
+	return done;
+}
+
+bool pendingRequestDone(const uint8_t handle)
+{
+	return handle < PENDING_TABLE_SIZE && _pendingRequests[handle].state == PENDING_DONE;
+}
+
+void pendingRequestComplete(const MyMessage &message)
+{
+	const uint8_t sender = message.getSender();
+	const uint8_t sensor = message.getSensor();
+	const bool echo = message.isEcho();
+	const uint8_t command = message.getCommand();
+	const uint8_t type = message.getType();
+	for (uint8_t handle = 0; handle < PENDING_TABLE_SIZE; handle++) {
+		pendingRequest_t &request = _pendingRequests[handle];
+		// an echo of our own message is no reply, blocking waits accept it like before
+		if (request.state != PENDING_WAITING || request.command != command || (echo && request.callback) ||
+		        (request.sender != PENDING_ANY && request.sender != sender) ||
+		        (request.sensor != PENDING_ANY && request.sensor != sensor) ||
+		        (request.type != PENDING_ANY && request.type != type)) {
+			continue;
+		}
+		if (request.callback) {
+			// free first, the callback may issue the next request
+			request.state = PENDING_FREE;
+			request.callback(&message);
+		} else {
+			request.state = PENDING_DONE;
+		}
+	}
+}
+
+uint8_t pendingRequestCount(void)
+{
+	uint8_t count = 0;
+	for (uint8_t handle = 0; handle < PENDING_TABLE_SIZE; handle++) {
+		count += (_pendingRequests[handle].state == PENDING_WAITING);
+	}
+	return count;
+}
+
+void pendingRequestProcess(void)
+{
+	const uint32_t now = hwMillis();
+	for (uint8_t handle = 0; handle < PENDING_TABLE_SIZE; handle++) {
+		pendingRequest_t &request = _pendingRequests[handle];
+		// polled entries time out in their wait loop
+		if (request.state == PENDING_WAITING && request.callback &&
+		        (int32_t)(now - request.deadlineMs) >= 0) {
+			PENDING_DEBUG(PSTR("!PRQ:TMO:ID=%" PRIu8 ",C=%" PRIu8 ",T=%" PRIu8 "\n"), request.sender,
+			              request.command, request.type);
+			request.state = PENDING_FREE;
+			request.callback(NULL);
+		}
+	}
+}
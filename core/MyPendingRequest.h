@@ -0,0 +1,138 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/**
+ * @file MyPendingRequest.h
+ *
+ * Table of expected replies (sender, child, command, type), @ref MY_PENDING_REQUESTS entries. Every
+ * message received for this node is matched against all entries, so several requests can be in
+ * flight. Entries with a callback are completed asynchronously (request timeout reported with a
+ * NULL message), entries without callback are polled by blocking waits. Callbacks run inside the
+ * receive path and must not call wait() or sleep(). Echoes never complete them.
+ *
+ * Blocking waits have PENDING_WAIT_SLOTS entries of their own, asynchronous requests cannot take
+ * them. Waits nested deeper fall back to checking the last received message after each pass.
+ *
+ * Pending request log messages, format: [!]SYSTEM:[SUB SYSTEM:]MESSAGE
+ *
+ * |E| SYS | SUB | Message                   | Comment
+ * |-|-----|-----|---------------------------|---------------------------------------------------------------
+ * |!| PRQ | ADD | FULL                      | No free entry, request not registered
+ * |!| PRQ | TMO | ID=%%d,C=%%d,T=%%d          | No reply from node (ID) with command (C) and type (T) in time
+ */
+
+#ifndef MyPendingRequest_h
+#define MyPendingRequest_h
+
+#if defined(MY_DEBUG_VERBOSE_CORE)
+#define PENDING_DEBUG(x,...)	DEBUG_OUTPUT(x, ##__VA_ARGS__)	//!< debug output
+#else
+#define PENDING_DEBUG(x,...)									//!< debug NULL
+#endif
+
+#define PENDING_ANY (0xFFu)			//!< wildcard for sender, child or type
+#define PENDING_REQUEST_NONE (0xFFu)	//!< invalid request handle
+#define PENDING_WAIT_SLOTS (2u)			//!< entries reserved for blocking waits, e.g. transportWait() in wait()
+#define PENDING_TABLE_SIZE (MY_PENDING_REQUESTS + PENDING_WAIT_SLOTS)	//!< entries in total
+
+/**
+ * @brief State of a table entry
+ */
+typedef enum {
+	PENDING_FREE,		//!< unused
+	PENDING_WAITING,	//!< waiting for the reply
+	PENDING_DONE		//!< reply received, entry without callback not released yet
+} pendingState_t;
+
+/**
+ * @brief Expected reply
+ */
+typedef struct {
+	uint32_t deadlineMs;		//!< hwMillis() after which the request times out
+	requestCallback_t callback;	//!< NULL: polled by a blocking wait
+	uint8_t sender;				//!< expected sender or PENDING_ANY
+	uint8_t sensor;				//!< expected child or PENDING_ANY
+	uint8_t command;			//!< expected command
+	uint8_t type;				//!< expected type or PENDING_ANY
+	uint8_t state;				//!< pendingState_t
+} pendingRequest_t;
+
+/**
+ * @brief Register an expected reply
+ * @param sender Expected sender or PENDING_ANY
+ * @param sensor Expected child or PENDING_ANY
+ * @param command Expected command
+ * @param type Expected type or PENDING_ANY
+ * @param timeoutMs Time until the callback is called with NULL
+ * @param callback Called once with the reply or NULL on timeout, NULL for polled entries
+ * @return handle, PENDING_REQUEST_NONE if the table is full
+ */
+uint8_t pendingRequestAdd(const uint8_t sender, const uint8_t sensor, const uint8_t command,
+                          const uint8_t type, const uint32_t timeoutMs, const requestCallback_t callback);
+
+/**
+ * @brief Register a blocking wait for a message
+ * @param command Expected command
+ * @param type Expected type or PENDING_ANY
+ * @param timeoutMs Time the caller waits
+ * @return handle, PENDING_REQUEST_NONE if all wait entries are taken (see pendingRequestPoll())
+ */
+uint8_t pendingRequestWait(const uint8_t command, const uint8_t type, const uint32_t timeoutMs);
+
+/**
+ * @brief Check a blocking wait
+ * @param handle Handle of pendingRequestWait()
+ * @param command Expected command, used without handle
+ * @param type Expected type or PENDING_ANY, used without handle
+ * @return true if the message was received
+ */
+bool pendingRequestPoll(const uint8_t handle, const uint8_t command, const uint8_t type);
+
+/**
+ * @brief Release an entry, the callback is not called
+ * @param handle
+ * @return true if the reply was received
+ */
+bool pendingRequestRelease(const uint8_t handle);
+
+/**
+ * @brief Reply received for a polled entry
+ * @param handle
+ * @return true if received
+ */
+bool pendingRequestDone(const uint8_t handle);
+
+/**
+ * @brief Complete all entries matching a received message
+ * @param message
+ */
+void pendingRequestComplete(const MyMessage &message);
+
+/**
+ * @brief Number of requests waiting for a reply
+ * @return count
+ */
+uint8_t pendingRequestCount(void);
+
+/**
+ * @brief Report timed out requests to their callbacks
+ */
+void pendingRequestProcess(void);
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include "MyProfiling.h"
+
+#if defined(MY_CORE_PROFILING)
+profileSample_t _profileSamples[PROFILE_SECTIONS];
+#endif
+
+void profileAccount(const profileSection_t section, const uint32_t durationUS)
+{
+#if defined(MY_CORE_PROFILING)
+	profileSample_t *sample = &_profileSamples[section];
+	if (sample->count == 0xFFFF) {
+		// keep average meaningful, restart accumulation
+		sample->totalUS = 0;
+		sample->count = 0;
+	}
+	sample->totalUS += durationUS;
+	sample->count++;
+	const uint16_t duration = durationUS > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(durationUS);
+	if (duration > sample->maxUS) {
+		sample->maxUS = duration;
+	}
+#else
+	(void)section;
+	(void)durationUS;
+#endif
+}
+
+uint8_t profileGetStatistics(void *data)
+{
+#if defined(MY_CORE_PROFILING)
+	uint8_t *out = static_cast<uint8_t *>(data);
+	*out++ = PROFILE_VERSION;
+	for (uint8_t i = 0; i < PROFILE_SECTIONS; i++) {
+		const profileSample_t *sample = &_profileSamples[i];
+		const uint16_t average = sample->count ? static_cast<uint16_t>(sample->totalUS / sample->count) : 0;
+		const uint16_t values[3] = { sample->count, sample->maxUS, average };
+		(void)memcpy(out, values, sizeof(values));
+		out += sizeof(values);
+	}
+	return static_cast<uint8_t>(out - static_cast<uint8_t *>(data));
+#else
+	(void)data;
+	return 0;
+#endif
+}
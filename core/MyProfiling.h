@@ -0,0 +1,75 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/**
+ * @file MyProfiling.h
+ *
+ * On target run time profiling of the core loop, enabled with @ref MY_CORE_PROFILING.
+ * Durations are measured with micros(), i.e. with a resolution of 4us (64 cycles) on a 16MHz AVR.
+ */
+
+#ifndef MyProfiling_h
+#define MyProfiling_h
+
+/**
+ * Profiled sections
+ */
+typedef enum {
+	PROFILE_PROCESS = 0,		//!< _process()
+	PROFILE_TRANSPORT_FIFO,		//!< transportProcessFIFO()
+	PROFILE_TRANSPORT_SEND,		//!< transportSend() incl. HAL
+	PROFILE_GATEWAY_AVAILABLE,	//!< gatewayTransportAvailable()
+	PROFILE_SECTIONS			//!< number of sections
+} profileSection_t;
+
+#define PROFILE_VERSION (1u)	//!< layout version of the profiling block
+
+/**
+ * Per section samples
+ */
+typedef struct {
+	uint32_t totalUS;	//!< sum of all durations
+	uint16_t maxUS;		//!< longest duration (saturated)
+	uint16_t count;		//!< number of samples (saturated)
+} profileSample_t;
+
+#if defined(MY_CORE_PROFILING)
+#define PROFILE_START(__section) const uint32_t _profileStart##__section = micros()	//!< start measurement
+#define PROFILE_END(__section) profileAccount(__section, micros() - _profileStart##__section)	//!< end measurement
+#else
+#define PROFILE_START(__section)	//!< start measurement
+#define PROFILE_END(__section)		//!< end measurement
+#endif
+
+/**
+ * @brief Account a measured duration
+ * @param section profiled section
+ * @param durationUS duration in us
+ */
+void profileAccount(const profileSection_t section, const uint32_t durationUS);
+
+/**
+ * @brief Copy profiling block: version (uint8_t), then per section count, max and average duration
+ * in us (uint16_t each, little endian)
+ * @param data buffer, at least MAX_PAYLOAD_SIZE bytes
+ * @return length of profiling block, 0 if profiling is disabled
+ */
+uint8_t profileGetStatistics(void *data);
+
+#endif
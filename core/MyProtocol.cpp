@@ -24,76 +24,331 @@
 #include <string.h>
 
 char _fmtBuffer[MY_GATEWAY_MAX_SEND_LENGTH];
-char _convBuffer[MAX_PAYLOAD_SIZE * 2 + 1];
+
+protocolParseResult_t protocolParseChar(protocolParser_t &parser, MyMessage &message, const char c)
+{
+	if (parser.column == 0 && parser.field == 0) {
+		// start of line
+		message.setSender(GATEWAY_ADDRESS);
+		message.setEcho(false);
+		parser.value = 0;
+		parser.length = 0;
+		parser.error = PROTOCOL_ERR_NONE;
+	}
+	if (c == '\n') {
+		protocolParseResult_t result = PROTOCOL_PARSE_ERROR;
+		if (parser.error == PROTOCOL_ERR_NONE) {
+			if (parser.field < 4 || (parser.field == 4 && parser.length == 0)) {
+				parser.error = PROTOCOL_ERR_FIELDS;
+				parser.errorColumn = parser.column;
+			} else if (parser.field == 4) {
+				// no payload, set default value
+				message.setType(static_cast<uint8_t>(parser.value));
+				message.set((uint8_t)0);
+				result = PROTOCOL_PARSE_DONE;
+			} else if (message.getCommand() == C_STREAM) {
+				if (parser.value) {
+					// odd number of hex characters
+					parser.error = PROTOCOL_ERR_HEX;
+					parser.errorColumn = parser.column;
+				} else {
+					(void)message.setLength(parser.length);
+					(void)message.setPayloadType(P_CUSTOM);
+					result = PROTOCOL_PARSE_DONE;
+				}
+			} else if (parser.length == 0) {
+				message.set((uint8_t)0);
+				result = PROTOCOL_PARSE_DONE;
+			} else {
+				// remove trailing carriage return
+				if (message.data[parser.length - 1] == '\r') {
+					parser.length--;
+				}
+				message.data[parser.length] = 0;
+				(void)message.setLength(parser.length);
+				(void)message.setPayloadType(P_STRING);
+				result = PROTOCOL_PARSE_DONE;
+			}
+		}
+		parser.field = 0;
+		parser.column = 0;
+		return result;
+	}
+	if (parser.column < 0xFF) {
+		parser.column++;
+	}
+	if (parser.error != PROTOCOL_ERR_NONE) {
+		// skip rest of line
+		return PROTOCOL_PARSE_BUSY;
+	}
+	if (parser.column > MY_GATEWAY_MAX_RECEIVE_LENGTH - 2) {
+		parser.error = PROTOCOL_ERR_LENGTH;
+		parser.errorColumn = parser.column;
+		return PROTOCOL_PARSE_BUSY;
+	}
+	if (parser.field < 5) {
+		// header field
+		if (c == ';') {
+			if (parser.length == 0) {
+				parser.error = PROTOCOL_ERR_NUMBER;
+				parser.errorColumn = parser.column;
+				return PROTOCOL_PARSE_BUSY;
+			}
+			const uint8_t value = static_cast<uint8_t>(parser.value);
+			switch (parser.field) {
+			case 0: // Radio id (destination)
+				message.setDestination(value);
+				break;
+			case 1: // Child id
+				message.setSensor(value);
+				break;
+			case 2: // Message type
+				message.setCommand(static_cast<mysensors_command_t>(value));
+				break;
+			case 3: // Should we request echo from destination?
+				message.setRequestEcho(value ? 1 : 0);
+				break;
+			case 4: // Data type
+				message.setType(value);
+				break;
+			}
+			parser.field++;
+			parser.value = 0;
+			parser.length = 0;
+		} else if (c >= '0' && c <= '9' && parser.value * 10 + (c - '0') <= 0xFF) {
+			parser.value = parser.value * 10 + (c - '0');
+			parser.length++;
+		} else if (c != '\r' || parser.field != 4) {
+			parser.error = PROTOCOL_ERR_NUMBER;
+			parser.errorColumn = parser.column;
+		}
+	} else if (parser.field == 5) {
+		// payload
+		if (c == ';') {
+			// remaining fields are ignored
+			parser.field++;
+		} else if (message.getCommand() == C_STREAM) {
+			// decode hex on the fly, value holds the pending high nibble + 1
+			if (c == '\r') {
+				return PROTOCOL_PARSE_BUSY;
+			}
+			if (!isxdigit(c)) {
+				parser.error = PROTOCOL_ERR_HEX;
+				parser.errorColumn = parser.column;
+			} else if (parser.value == 0) {
+				parser.value = convertH2I(c) + 1;
+			} else {
+				if (parser.length < MAX_PAYLOAD_SIZE) {
+					message.data[parser.length++] = static_cast<char>(((parser.value - 1) << 4) | convertH2I(c));
+				}
+				parser.value = 0;
+			}
+		} else if (parser.length < MAX_PAYLOAD_SIZE) {
+			// longer payloads are truncated
+			message.data[parser.length++] = c;
+		}
+	}
+	return PROTOCOL_PARSE_BUSY;
+}
 
 bool protocolSerial2MyMessage(MyMessage &message, char *inputString)
 {
-	char *str, *p;
-	uint8_t index = 0;
-	mysensors_command_t command = C_INVALID_7;
-	message.setSender(GATEWAY_ADDRESS);
-	//message.setLast(GATEWAY_ADDRESS);
-	message.setEcho(false);
+	protocolParser_t parser;
+	(void)memset(&parser, 0, sizeof(parser));
+	while (*inputString && *inputString != '\n') {
+		(void)protocolParseChar(parser, message, *inputString++);
+	}
+	return protocolParseChar(parser, message, '\n') == PROTOCOL_PARSE_DONE;
+}
+
+uint16_t protocolCRC16(const uint8_t *data, const uint8_t length)
+{
+	uint16_t crc = 0xFFFF;
+	for (uint8_t i = 0; i < length; i++) {
+		crc ^= static_cast<uint16_t>(data[i]) << 8;
+		for (uint8_t bit = 0; bit < 8; bit++) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+uint8_t protocolMyMessage2Binary(const MyMessage &message, uint8_t *frame)
+{
+	uint8_t raw[PROTOCOL_BINARY_MAX_RAW];
+	uint8_t rawLength = HEADER_SIZE + message.getLength();
+	(void)memcpy(raw, &message.sender, rawLength);
+	const uint16_t crc = protocolCRC16(raw, rawLength);
+	raw[rawLength++] = static_cast<uint8_t>(crc);
+	raw[rawLength++] = static_cast<uint8_t>(crc >> 8);
+
+	uint8_t pos = 0;
+#if defined(DEBUG_OUTPUT_ENABLED)
+	// separate frame from preceding debug text
+	frame[pos++] = 0x00;
+#endif
+	// COBS, blocks are shorter than 254 bytes
+	uint8_t codePos = pos++;
+	uint8_t code = 1;
+	for (uint8_t i = 0; i < rawLength; i++) {
+		if (raw[i] == 0x00) {
+			frame[codePos] = code;
+			codePos = pos++;
+			code = 1;
+		} else {
+			frame[pos++] = raw[i];
+			code++;
+		}
+	}
+	frame[codePos] = code;
+	frame[pos++] = 0x00;
+	return pos;
+}
+
+bool protocolBinary2MyMessage(MyMessage &message, const uint8_t *frame, const uint8_t length)
+{
+	uint8_t raw[PROTOCOL_BINARY_MAX_RAW + 1];	// incl. implicit zero of last block
+	uint8_t rawLength = 0;
+	uint8_t pos = 0;
+	while (pos < length) {
+		const uint8_t code = frame[pos++];
+		if (code == 0x00 || pos + code - 1 > length || rawLength + code > PROTOCOL_BINARY_MAX_RAW + 1) {
+			return false;
+		}
+		for (uint8_t i = 1; i < code; i++) {
+			raw[rawLength++] = frame[pos++];
+		}
+		if (code != 0xFF && pos < length) {
+			raw[rawLength++] = 0x00;
+		}
+	}
+	if (rawLength < HEADER_SIZE + 2) {
+		return false;
+	}
+	rawLength -= 2;
+	const uint16_t crc = static_cast<uint16_t>(raw[rawLength]) | (static_cast<uint16_t>(raw[rawLength + 1]) << 8);
+	if (crc != protocolCRC16(raw, rawLength)) {
+		return false;
+	}
+	(void)memcpy(&message.sender, raw, rawLength);
+	if (!message.isProtocolVersionValid() || rawLength != HEADER_SIZE + message.getLength()) {
+		return false;
+	}
+	message.data[message.getLength()] = 0;
+	return true;
+}
 
-	// Extract command data coming on serial line
-	for (str = strtok_r(inputString, ";", &p); // split using semicolon
-	        str && index < 5; // loop while str is not null an max 4 times
-	        str = strtok_r(NULL, ";", &p), index++ // get subsequent tokens
-	    ) {
-		switch (index) {
-		case 0: // Radio id (destination)
-			message.setDestination(atoi(str));
-			break;
-		case 1: // Child id
-			message.setSensor(atoi(str));
-			break;
-		case 2: // Message type
-			command = static_cast<mysensors_command_t>(atoi(str));
-			message.setCommand(command);
-			break;
-		case 3: // Should we request echo from destination?
-			message.setRequestEcho(atoi(str) ? 1 : 0);
-			break;
-		case 4: // Data type
-			message.setType(atoi(str));
-			break;
+// decimal uint8_t followed by separator
+static char *_protocolFormatField(char *p, const uint8_t value)
+{
+	if (value >= 100) {
+		*p++ = '0' + value / 100;
+	}
+	if (value >= 10) {
+		*p++ = '0' + (value / 10) % 10;
+	}
+	*p++ = '0' + value % 10;
+	*p++ = ';';
+	return p;
+}
+
+// fixed point float, same output as dtostrf(value, 2, decimals) for the usual sensor precision
+static char *_protocolFormatFloat(char *p, const float value, const uint8_t decimals)
+{
+	const float absValue = value < 0 ? -value : value;
+	// beyond 2^24 the float mantissa is exhausted, also catches NaN and inf
+	if (decimals > 4 || !(absValue < 16777216.0f)) {
+		(void)dtostrf(value, 2, decimals, p);
+		return p + strlen(p);
+	}
+	uint16_t scale = 1;
+	for (uint8_t i = 0; i < decimals; i++) {
+		scale *= 10;
+	}
+	// integer part is exact, round the fraction only
+	uint32_t integer = static_cast<uint32_t>(absValue);
+	uint16_t fraction = static_cast<uint16_t>((absValue - integer) * scale + 0.5f);
+	if (fraction >= scale) {
+		fraction -= scale;
+		integer++;
+	}
+	char digits[10];
+	uint8_t count = 0;
+	do {
+		digits[count++] = '0' + integer % 10;
+		integer /= 10;
+	} while (integer);
+	// dtostrf pads to a width of 2
+	if (count + (value < 0) + (decimals ? decimals + 1 : 0) < 2) {
+		*p++ = ' ';
+	}
+	if (value < 0) {
+		*p++ = '-';
+	}
+	while (count) {
+		*p++ = digits[--count];
+	}
+	if (decimals) {
+		*p++ = '.';
+		for (uint8_t i = decimals; i > 0; i--) {
+			p[i - 1] = '0' + fraction % 10;
+			fraction /= 10;
 		}
+		p += decimals;
 	}
-	// payload
-	if (str == NULL) {
-		// no payload, set default value
-		message.set((uint8_t)0);
-	} else if (command == C_STREAM) {
-		// stream payload
-		uint8_t bvalue[MAX_PAYLOAD_SIZE];
-		uint8_t blen = 0;
-		while (*str) {
-			uint8_t val;
-			val = convertH2I(*str++) << 4;
-			val += convertH2I(*str++);
-			bvalue[blen] = val;
-			blen++;
+	return p;
+}
+
+uint8_t protocolFormatSerial(const MyMessage &message, char *buffer)
+{
+	char *p = _protocolFormatField(buffer, message.getSender());
+	p = _protocolFormatField(p, message.getSensor());
+	p = _protocolFormatField(p, message.getCommand());
+	p = _protocolFormatField(p, message.isEcho());
+	p = _protocolFormatField(p, message.getType());
+	// payload, formatted in place
+	const uint8_t length = message.getLength();
+	switch (message.getPayloadType()) {
+	case P_STRING:
+		for (uint8_t i = 0; i < length && message.data[i]; i++) {
+			*p++ = message.data[i];
 		}
-		message.set(bvalue, blen);
-	} else {
-		// regular payload
-		char *value = str;
-		// Remove trailing carriage return and newline character (if it exists)
-		const uint8_t lastCharacter = strlen(value) - 1;
-		if (value[lastCharacter] == '\r' || value[lastCharacter] == '\n') {
-			value[lastCharacter] = '\0';
+		break;
+	case P_BYTE:
+		p += strlen(utoa(message.bValue, p, 10));
+		break;
+	case P_INT16:
+		p += strlen(itoa(message.iValue, p, 10));
+		break;
+	case P_UINT16:
+		p += strlen(utoa(message.uiValue, p, 10));
+		break;
+	case P_LONG32:
+		p += strlen(ltoa(message.lValue, p, 10));
+		break;
+	case P_ULONG32:
+		p += strlen(ultoa(message.ulValue, p, 10));
+		break;
+	case P_FLOAT32:
+		p = _protocolFormatFloat(p, message.fValue, min(message.fPrecision, (uint8_t)8u));
+		break;
+	case P_CUSTOM:
+		for (uint8_t i = 0; i < length; i++) {
+			*p++ = convertI2H(message.data[i] >> 4);
+			*p++ = convertI2H(message.data[i]);
 		}
-		message.set(value);
+		break;
+	default:
+		break;
 	}
-	return (index == 5);
+	*p++ = '\n';
+	*p = '\0';
+	return static_cast<uint8_t>(p - buffer);
 }
 
 char *protocolMyMessage2Serial(const MyMessage &message)
 {
-	(void)snprintf_P(_fmtBuffer, (uint8_t)MY_GATEWAY_MAX_SEND_LENGTH,
-	                 PSTR("%" PRIu8 ";%" PRIu8 ";%" PRIu8 ";%" PRIu8 ";%" PRIu8 ";%s\n"), message.getSender(),
-	                 message.getSensor(), message.getCommand(), message.isEcho(), message.getType(),
-	                 message.getString(_convBuffer));
+	(void)protocolFormatSerial(message, _fmtBuffer);
 	return _fmtBuffer;
 }
 
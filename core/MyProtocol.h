@@ -22,6 +22,36 @@
 
 #include "MySensorsCore.h"
 
+// result of feeding one character to the streaming parser
+typedef enum {
+	PROTOCOL_PARSE_BUSY,	// line not complete yet
+	PROTOCOL_PARSE_DONE,	// message complete
+	PROTOCOL_PARSE_ERROR	// line complete but invalid, see parser error
+} protocolParseResult_t;
+
+// parse errors, reported at the end of the line
+typedef enum {
+	PROTOCOL_ERR_NONE,		// no error
+	PROTOCOL_ERR_NUMBER,	// header field is not a number in 0..255
+	PROTOCOL_ERR_FIELDS,	// less than 5 header fields
+	PROTOCOL_ERR_HEX,		// invalid hex character or odd number of hex characters in stream payload
+	PROTOCOL_ERR_LENGTH		// line longer than MY_GATEWAY_MAX_RECEIVE_LENGTH - 2 characters
+} protocolParseError_t;
+
+// streaming parser state
+typedef struct {
+	uint8_t field;		// current field: 0..4 header, 5 payload, 6 ignored rest
+	uint16_t value;		// value of current header field or pending hex nibble
+	uint8_t length;		// digits of current header field or payload length
+	uint8_t column;		// characters in current line
+	protocolParseError_t error;	// first error in current line
+	uint8_t errorColumn;	// column of first error
+} protocolParser_t;
+
+// feed one character of a line "destination;sensor;command;echo;type;payload\n"
+// the message is built in place, no line buffer is used
+protocolParseResult_t protocolParseChar(protocolParser_t &parser, MyMessage &message, const char c);
+
 // parse(message, inputString)
 // parse a string into a message element
 // returns true if successfully parsed the input string
@@ -30,5 +60,23 @@ bool protocolSerial2MyMessage(MyMessage &message, char *inputString);
 // Format MyMessage to the protocol representation
 char *protocolMyMessage2Serial(const MyMessage &message);
 
+// Format MyMessage into buffer (at least MY_GATEWAY_MAX_SEND_LENGTH bytes) without printf
+// returns line length
+uint8_t protocolFormatSerial(const MyMessage &message, char *buffer);
+
+#define PROTOCOL_BINARY_MAX_RAW (HEADER_SIZE + MAX_PAYLOAD_SIZE + 2)	// header, payload, CRC
+#define PROTOCOL_BINARY_MAX_FRAME (PROTOCOL_BINARY_MAX_RAW + 3)			// COBS overhead, delimiters
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+uint16_t protocolCRC16(const uint8_t *data, const uint8_t length);
+
+// encode message into a binary frame incl. delimiter(s), frame must hold PROTOCOL_BINARY_MAX_FRAME bytes
+// returns frame length
+uint8_t protocolMyMessage2Binary(const MyMessage &message, uint8_t *frame);
+
+// decode a COBS encoded frame without delimiters into a message
+// returns true if length and CRC are valid
+bool protocolBinary2MyMessage(MyMessage &message, const uint8_t *frame, const uint8_t length);
+
 
 #endif
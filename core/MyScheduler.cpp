@@ -0,0 +1,208 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include "MyScheduler.h"
+
+#if defined(MY_SCHEDULER_FEATURE)
+schedulerTask_t _schedulerTasks[MY_SCHEDULER_TASKS];
+uint8_t _schedulerOrder[MY_SCHEDULER_TASKS];	// handles of scheduled tasks, earliest due first
+uint8_t _schedulerCount = 0;
+uint32_t _schedulerProcessMs = 0;
+bool _schedulerRunning = false;
+
+void _schedulerInsert(const uint8_t handle)
+{
+	const uint32_t dueMs = _schedulerTasks[handle].dueMs;
+	uint8_t position = _schedulerCount;
+	// signed difference, order survives the millis() wrap
+	while (position && (int32_t)(_schedulerTasks[_schedulerOrder[position - 1]].dueMs - dueMs) > 0) {
+		_schedulerOrder[position] = _schedulerOrder[position - 1];
+		position--;
+	}
+	_schedulerOrder[position] = handle;
+	_schedulerCount++;
+}
+
+void _schedulerRemove(const uint8_t handle)
+{
+	uint8_t position = 0;
+	while (position < _schedulerCount && _schedulerOrder[position] != handle) {
+		position++;
+	}
+	if (position == _schedulerCount) {
+		return;
+	}
+	_schedulerCount--;
+	for (; position < _schedulerCount; position++) {
+		_schedulerOrder[position] = _schedulerOrder[position + 1];
+	}
+}
+
+// millis() stops while powered down, keep the remaining time of all tasks
+void _schedulerShift(const uint32_t sleptMs)
+{
+	for (uint8_t position = 0; position < _schedulerCount; position++) {
+		_schedulerTasks[_schedulerOrder[position]].dueMs -= sleptMs;
+	}
+}
+#endif
+
+schedulerHandle_t schedulerAdd(const taskCallback_t callback, const uint32_t delayMs,
+                               const uint32_t periodMs)
+{
+#if defined(MY_SCHEDULER_FEATURE)
+	if (!callback) {
+		return SCHEDULER_TASK_NONE;
+	}
+	for (uint8_t slot = 0; slot < MY_SCHEDULER_TASKS; slot++) {
+		schedulerTask_t &task = _schedulerTasks[slot];
+		if (!task.callback) {
+			task.dueMs = hwMillis() + delayMs;
+			task.periodMs = periodMs;
+			task.callback = callback;
+			_schedulerInsert(slot);
+			return (schedulerHandle_t)task.generation << 8 | slot;
+		}
+	}
+	SCHEDULER_DEBUG(PSTR("!SCH:ADD:FULL\n"));
+#else
+	(void)callback;
+	(void)delayMs;
+	(void)periodMs;
+#endif
+	return SCHEDULER_TASK_NONE;
+}
+
+bool schedulerCancel(const schedulerHandle_t handle)
+{
+#if defined(MY_SCHEDULER_FEATURE)
+	const uint8_t slot = (uint8_t)handle;
+	// a stale handle must not cancel the task now using the slot
+	if (slot >= MY_SCHEDULER_TASKS || !_schedulerTasks[slot].callback ||
+	        _schedulerTasks[slot].generation != (uint8_t)(handle >> 8)) {
+		return false;
+	}
+	_schedulerRemove(slot);
+	_schedulerTasks[slot].callback = NULL;
+	_schedulerTasks[slot].generation++;
+	return true;
+#else
+	(void)handle;
+	return false;
+#endif
+}
+
+void schedulerProcess(void)
+{
+#if defined(MY_SCHEDULER_FEATURE)
+	if (_schedulerRunning) {
+		// task called wait()
+		return;
+	}
+	_schedulerRunning = true;
+	// bounded, a task re-adding itself without delay runs once per pass
+	for (uint8_t runs = 0; runs < MY_SCHEDULER_TASKS && _schedulerCount; runs++) {
+		const uint32_t now = hwMillis();
+		const uint8_t handle = _schedulerOrder[0];
+		schedulerTask_t &task = _schedulerTasks[handle];
+		if ((int32_t)(now - task.dueMs) < 0) {
+			break;
+		}
+		const taskCallback_t callback = task.callback;
+		_schedulerRemove(handle);
+		if (task.periodMs) {
+			task.dueMs += task.periodMs;
+			if ((int32_t)(now - task.dueMs) >= 0) {
+				// overran, skip missed runs instead of running them back to back
+				task.dueMs = now + task.periodMs;
+			}
+			_schedulerInsert(handle);
+		} else {
+			// free before the call, the slot can be reused by the task
+			task.callback = NULL;
+			task.generation++;
+		}
+		callback();
+	}
+	_schedulerRunning = false;
+#endif
+}
+
+uint32_t schedulerTimeToNext(void)
+{
+#if defined(MY_SCHEDULER_FEATURE)
+	if (!_schedulerCount) {
+		return SCHEDULER_NO_TASK;
+	}
+	const int32_t remaining = (int32_t)(_schedulerTasks[_schedulerOrder[0]].dueMs - hwMillis());
+	return remaining > 0 ? (uint32_t)remaining : 0;
+#else
+	return SCHEDULER_NO_TASK;
+#endif
+}
+
+void schedulerRun(void)
+{
+#if defined(MY_SCHEDULER_FEATURE)
+	const uint32_t now = hwMillis();
+	// timers of the transport state machine and pending requests are served at least this often
+	bool work = (now - _schedulerProcessMs >= MY_SCHEDULER_PROCESS_MS);
+#if defined(MY_GATEWAY_FEATURE)
+	// controller input is polled
+	work = true;
+#endif
+#if defined(MY_SENSOR_NETWORK)
+	work = work || transportHALInterruptPending() || !isTransportReady() || !deferredTimeToNext();
+#endif
+	if (work) {
+		_schedulerProcessMs = now;
+		_process();	// runs due tasks as well
+	} else {
+		schedulerProcess();
+	}
+	const uint32_t untilTask = schedulerTimeToNext();
+	if (!untilTask) {
+		return;
+	}
+#if defined(MY_SCHEDULER_POWER_DOWN) && defined(MY_SENSOR_NETWORK)
+	// nothing may arrive for a reply in flight while the transport is down
+	if (untilTask != SCHEDULER_NO_TASK && untilTask >= MY_SCHEDULER_POWER_DOWN_MIN_MS &&
+	        isTransportReady() && !deferredPending() && !pendingRequestCount() &&
+	        !transportHALInterruptPending()) {
+		SCHEDULER_DEBUG(PSTR("SCH:SLP:MS=%" PRIu32 "\n"), untilTask);
+		if (_sleep(untilTask) != MY_SLEEP_NOT_POSSIBLE) {
+			_schedulerShift(untilTask - getSleepRemaining());
+			return;
+		}
+	}
+#endif
+#if defined(MY_SENSOR_NETWORK)
+	// RX0/RX1 overrun within two frame times, the 1.024ms timer0 tick is too slow at high bitrates
+	if (digitalPinToInterrupt(CAN_INT) == NOT_AN_INTERRUPT) {
+		// CAN_INT cannot wake the CPU, poll instead of idling
+		return;
+	}
+	hwIdle(digitalPinToInterrupt(CAN_INT));
+#else
+	hwIdle(INVALID_INTERRUPT_NUM);
+#endif
+#else
+	_process();
+#endif
+}
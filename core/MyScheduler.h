@@ -0,0 +1,109 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/**
+ * @file MyScheduler.h
+ *
+ * Cooperative scheduler for periodic and one-shot tasks, enabled with @ref MY_SCHEDULER_TASKS.
+ * Tasks are kept sorted by due time and run from _process(), i.e. also during wait(). A sketch
+ * that leaves its work to tasks calls schedulerRun() from loop(): _process() is only called when
+ * CAN_INT signals a frame, a deferred reply is due, the transport is not ready or
+ * @ref MY_SCHEDULER_PROCESS_MS elapsed. In between, the CPU idles until the next interrupt or,
+ * with @ref MY_SCHEDULER_POWER_DOWN, sleeps until the next task is due. CAN_INT is attached as wake up
+ * interrupt while idling; if it is no external interrupt pin (pin 2 or 3 on ATmega328P), the CPU
+ * does not idle and schedulerRun() returns to poll CAN_INT instead.
+ *
+ * Scheduler log messages, format: [!]SYSTEM:[SUB SYSTEM:]MESSAGE
+ *
+ * |E| SYS | SUB | Message                   | Comment
+ * |-|-----|-----|---------------------------|---------------------------------------------------------------
+ * |!| SCH | ADD | FULL                      | No free task slot
+ * | | SCH | SLP | MS=%%d                     | Power down until next task due in (MS)
+ */
+
+#ifndef MyScheduler_h
+#define MyScheduler_h
+
+#if (MY_SCHEDULER_TASKS > 0)
+#define MY_SCHEDULER_FEATURE	//!< scheduler active
+#endif
+
+#if defined(MY_DEBUG_VERBOSE_CORE)
+#define SCHEDULER_DEBUG(x,...)	DEBUG_OUTPUT(x, ##__VA_ARGS__)	//!< debug output
+#else
+#define SCHEDULER_DEBUG(x,...)									//!< debug NULL
+#endif
+
+#define SCHEDULER_TASK_NONE (0xFFFFu)			//!< invalid task handle
+#define SCHEDULER_NO_TASK (0xFFFFFFFFul)	//!< schedulerTimeToNext(): no task scheduled
+
+/**
+ * @brief Task handle, slot in the low byte and generation of the slot in the high byte
+ */
+typedef uint16_t schedulerHandle_t;
+
+/**
+ * @brief Task function
+ */
+typedef void (*taskCallback_t)(void);
+
+/**
+ * @brief Scheduled task
+ */
+typedef struct {
+	uint32_t dueMs;				//!< hwMillis() of next run
+	uint32_t periodMs;			//!< 0: one-shot
+	taskCallback_t callback;	//!< NULL: slot free
+	uint8_t generation;			//!< incremented when the slot is freed, handles of earlier tasks are stale
+} schedulerTask_t;
+
+/**
+ * @brief Schedule a task
+ * @param callback Task function, may add and cancel tasks but should not block
+ * @param delayMs Time until first run
+ * @param periodMs Interval of further runs, 0 for a one-shot task
+ * @return handle, SCHEDULER_TASK_NONE if all slots are taken
+ */
+schedulerHandle_t schedulerAdd(const taskCallback_t callback, const uint32_t delayMs, const uint32_t periodMs);
+
+/**
+ * @brief Remove a task
+ * @param handle Handle returned by schedulerAdd(), stale after the task was cancelled or a one-shot task ran
+ * @return true if the task was scheduled
+ */
+bool schedulerCancel(const schedulerHandle_t handle);
+
+/**
+ * @brief Run due tasks, called from _process()
+ */
+void schedulerProcess(void);
+
+/**
+ * @brief Time until the next task is due
+ * @return ms, 0 if due, SCHEDULER_NO_TASK if no task scheduled
+ */
+uint32_t schedulerTimeToNext(void);
+
+/**
+ * @brief One scheduler pass, call from loop(): process if work is signalled, run due tasks, then idle
+ * or power down until the next deadline
+ */
+void schedulerRun(void);
+
+#endif
@@ -38,6 +38,11 @@ static uint8_t waitLock = 0;
 static uint8_t processLock = 0;
 #endif
 
+#if defined(__linux__)
+static bool _processBusy = false;
+static uint32_t _processIdleSleepUS = 0;
+#endif
+
 #if defined(DEBUG_OUTPUT_ENABLED)
 char _convBuf[MAX_PAYLOAD_SIZE * 2 + 1];
 #endif
@@ -62,6 +67,7 @@ void _process(void)
 	}
 	processLock++;
 #endif
+	PROFILE_START(PROFILE_PROCESS);
 	doYield();
 
 #if defined(MY_INCLUSION_MODE_FEATURE)
@@ -74,17 +80,42 @@ void _process(void)
 
 #if defined(MY_SENSOR_NETWORK)
 	transportProcess();
+	deferredProcess(false);
+#endif
+	pendingRequestProcess();
+#if defined(MY_SCHEDULER_FEATURE)
+	schedulerProcess();
+#endif
+#if defined(MY_OUTBOX_FEATURE)
+	outboxProcess();
 #endif
+	PROFILE_END(PROFILE_PROCESS);
 
 #if defined(__linux__)
-	// To avoid high cpu usage
-	usleep(10000); // 10ms
+	// To avoid high cpu usage, sleep only when idle and back off exponentially
+	if (_processBusy) {
+		_processBusy = false;
+		_processIdleSleepUS = 0;
+	} else {
+		_processIdleSleepUS = _processIdleSleepUS ? _processIdleSleepUS * 2 : 100;
+		if (_processIdleSleepUS > MY_LINUX_IDLE_SLEEP_US) {
+			_processIdleSleepUS = MY_LINUX_IDLE_SLEEP_US;
+		}
+		usleep(_processIdleSleepUS);
+	}
 #endif
 #if defined(MY_DEBUG_VERBOSE_CORE)
 	processLock--;
 #endif
 }
 
+void _processActivity(void)
+{
+#if defined(__linux__)
+	_processBusy = true;
+#endif
+}
+
 void _infiniteLoop(void)
 {
 #if defined(__linux__)
@@ -229,6 +260,16 @@ void presentNode(void)
 
 
 
+#if defined(MY_SENSOR_NETWORK)
+	// defer presentation with jitter while the bus is busy, e.g. all nodes starting after a power cut
+	const uint32_t deferStartMS = hwMillis();
+	while (getBusLoad() >= MY_BUS_LOAD_HIGH_PERCENT &&
+	        hwMillis() - deferStartMS < MY_BUS_LOAD_PRESENT_DEFER_MS) {
+		CORE_DEBUG(PSTR("MCO:PRE:DEF,LD=%" PRIu8 "\n"), getBusLoad());	// presentation deferred, bus load
+		wait(50 + ((hwMillis() + getNodeId() * 97u) & 0xFF));
+	}
+#endif
+
 	// Send signing preferences for this node to the GW
 	//signerPresentation(_msgTmp, GATEWAY_ADDRESS);
 
@@ -311,7 +352,19 @@ bool _sendRoute(MyMessage &message)
 	}
 #endif
 #if defined(MY_SENSOR_NETWORK)
-	return transportSendRoute(message);
+#if defined(MY_OUTBOX_FEATURE)
+	if (outboxDefer(message)) {
+		// not sent yet
+		return false;
+	}
+#endif
+	const bool result = transportSendRoute(message);
+#if defined(MY_OUTBOX_FEATURE)
+	if (!result) {
+		outboxPush(message);
+	}
+#endif
+	return result;
 #else
 	return false;
 #endif
@@ -407,6 +460,21 @@ bool request(const uint8_t childSensorId, const uint8_t variableType, const uint
 	return _sendRoute(build(_msgTmp, destination, childSensorId, C_REQ, variableType).set(""));
 }
 
+bool requestAsync(const uint8_t childSensorId, const uint8_t variableType, const uint8_t destination,
+                  const uint32_t timeoutMS, const requestCallback_t callback)
+{
+	const uint8_t handle = pendingRequestAdd(destination, childSensorId, C_SET, variableType,
+	                                         timeoutMS, callback);
+	if (handle == PENDING_REQUEST_NONE) {
+		return false;
+	}
+	if (!request(childSensorId, variableType, destination)) {
+		(void)pendingRequestRelease(handle);
+		return false;
+	}
+	return true;
+}
+
 bool requestTime(const bool requestEcho)
 {
 	return _sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL, I_TIME,
@@ -414,103 +482,240 @@ bool requestTime(const bool requestEcho)
 }
 
 // Message delivered through _msg
-bool _processInternalCoreMessage(void)
+bool _processInternalHandled(void)
+{
+	return true;
+}
+
+bool _processInternalReboot(void)
 {
-	const uint8_t type = _msg.getType();
-	if (_msg.getSender() == GATEWAY_ADDRESS) {
-		if (type == I_REBOOT) {
 #if !defined(MY_DISABLE_REMOTE_RESET)
-			setIndication(INDICATION_REBOOT);
-			// WDT fuse should be enabled
-			hwReboot();
+	setIndication(INDICATION_REBOOT);
+	// WDT fuse should be enabled
+	hwReboot();
 #endif
-		} else if (type == I_REGISTRATION_RESPONSE) {
+	return true;
+}
+
+bool _processInternalRegistrationResponse(void)
+{
 #if defined (MY_REGISTRATION_FEATURE) && !defined(MY_GATEWAY_FEATURE)
-			_coreConfig.nodeRegistered = _msg.getBool();
-			setIndication(INDICATION_GOT_REGISTRATION);
-			CORE_DEBUG(PSTR("MCO:PIM:NODE REG=%" PRIu8 "\n"), _coreConfig.nodeRegistered);	// node registration
-#endif
-		} else if (type == I_CONFIG) {
-			// Pick up configuration from controller (currently only metric/imperial) and store it in eeprom if changed
-			_coreConfig.controllerConfig.isMetric = _msg.data[0] == 0x00 ||
-			                                        _msg.data[0] == 'M'; // metric if null terminated or M
-			//hwWriteConfigBlock((void*)&_coreConfig.controllerConfig, (void*)EEPROM_CONTROLLER_CONFIG_ADDRESS,
-			//                   sizeof(controllerConfig_t));
-		} else if (type == I_PRESENTATION) {
-			// Re-send node presentation to controller
-			presentNode();
-		} else if (type == I_HEARTBEAT_REQUEST) {
-			(void)sendHeartbeat();
-		} else if (type == I_VERSION) {
+	_coreConfig.nodeRegistered = _msg.getBool();
+	setIndication(INDICATION_GOT_REGISTRATION);
+	CORE_DEBUG(PSTR("MCO:PIM:NODE REG=%" PRIu8 "\n"), _coreConfig.nodeRegistered);	// node registration
+#endif
+	return true;
+}
+
+bool _processInternalConfig(void)
+{
+	// Pick up configuration from controller (currently only metric/imperial) and store it in eeprom if changed
+	_coreConfig.controllerConfig.isMetric = _msg.data[0] == 0x00 ||
+	                                        _msg.data[0] == 'M'; // metric if null terminated or M
+	//hwWriteConfigBlock((void*)&_coreConfig.controllerConfig, (void*)EEPROM_CONTROLLER_CONFIG_ADDRESS,
+	//                   sizeof(controllerConfig_t));
+	return true;
+}
+
+bool _processInternalPresentation(void)
+{
+	// Re-send node presentation to controller
+	presentNode();
+	return true;
+}
+
+bool _processInternalHeartbeatRequest(void)
+{
+	(void)sendHeartbeat();
+	return true;
+}
+
+bool _processInternalVersion(void)
+{
 #if !defined(MY_GATEWAY_FEATURE)
-			(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
-			                       I_VERSION).set(MYSENSORS_LIBRARY_VERSION_INT));
-#endif
-		} else if (type == I_TIME) {
-			// Deliver time to callback
-			if (receiveTime) {
-				receiveTime(_msg.getULong());
-			}
-		}  else if (type == I_CHILDREN) {
-			if (_msg.data[0] == 'C') {
-
-			}
-		} else if (type == I_DEBUG) {
+	(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
+	                       I_VERSION).set(MYSENSORS_LIBRARY_VERSION_INT));
+#endif
+	return true;
+}
+
+bool _processInternalTime(void)
+{
+	// Deliver time to callback
+	if (receiveTime) {
+		receiveTime(_msg.getULong());
+	}
+	return true;
+}
+
+bool _processInternalDebug(void)
+{
 #if defined(MY_SPECIAL_DEBUG)
-			const char debug_msg = _msg.data[0];
-			if (debug_msg == 'R') {		// routing table
-
-			} else if (debug_msg == 'V') {	// CPU voltage
-				(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
-				                       I_DEBUG).set(hwCPUVoltage()));
-			} else if (debug_msg == 'F') {	// CPU frequency in 1/10Mhz
-				(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
-				                       I_DEBUG).set(hwCPUFrequency()));
-			} else if (debug_msg == 'M') {	// free memory
-				(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
-				                       I_DEBUG).set(hwFreeMem()));
-			} else if (debug_msg == 'E') {	// clear MySensors eeprom area and reboot
-				(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL, I_DEBUG).set("OK"));
-				for (uint16_t i = EEPROM_START; i<EEPROM_LOCAL_CONFIG_ADDRESS; i++) {
-					//hwWriteConfig(i, 0xFF);
-				}
-				setIndication(INDICATION_REBOOT);
-				hwReboot();
-			}
+	const char debug_msg = _msg.data[0];
+	if (debug_msg == 'R') {		// routing table
+
+	} else if (debug_msg == 'V') {	// CPU voltage
+		(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
+		                       I_DEBUG).set(hwCPUVoltage()));
+	} else if (debug_msg == 'F') {	// CPU frequency in 1/10Mhz
+		(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
+		                       I_DEBUG).set(hwCPUFrequency()));
+	} else if (debug_msg == 'M') {	// free memory
+		(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
+		                       I_DEBUG).set(hwFreeMem()));
+	} else if (debug_msg == 'E') {	// clear MySensors eeprom area and reboot
+		(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL, I_DEBUG).set("OK"));
+		// no EEPROM area in use, nothing to clear
+		setIndication(INDICATION_REBOOT);
+		hwReboot();
+	} else if (debug_msg == 'O') {	// outbox statistics block
+		uint8_t stats[MAX_PAYLOAD_SIZE];
+		const uint8_t statsLength = outboxGetStatistics(stats);
+		if (statsLength) {
+			(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
+			                       I_DEBUG).set(stats, statsLength));
+		}
+	} else if (debug_msg == 'P') {	// core loop profiling block
+		uint8_t profile[MAX_PAYLOAD_SIZE];
+		const uint8_t profileLength = profileGetStatistics(profile);
+		if (profileLength) {
+			(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
+			                       I_DEBUG).set(profile, profileLength));
+		}
+#if defined(MY_GATEWAY_FEATURE)
+	} else if (debug_msg == 'G') {	// gateway queue and link statistics block
+		uint8_t stats[MAX_PAYLOAD_SIZE];
+		const uint8_t statsLength = gatewayTransportGetStatistics(stats);
+		if (statsLength) {
+			(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
+			                       I_DEBUG).set(stats, statsLength));
+		}
+	} else if (debug_msg == 'B') {	// gateway queue to the bus statistics block
+		uint8_t stats[MAX_PAYLOAD_SIZE];
+		const uint8_t statsLength = gatewayTransportGetBusStatistics(stats);
+		if (statsLength) {
+			(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
+			                       I_DEBUG).set(stats, statsLength));
+		}
 #endif
-		} else {
-			return false; // further processing required
+#if defined(MY_SENSOR_NETWORK)
+	} else if (debug_msg == 'D') {	// duplicated messages dropped by transport
+		(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
+		                       I_DEBUG).set(transportHALGetDuplicateCount()));
+	} else if (debug_msg == 'S' || debug_msg == 'A') {	// transport / reassembly statistics block
+		uint8_t stats[MAX_PAYLOAD_SIZE];
+		const uint8_t statsLength = transportHALGetStatistics(debug_msg, stats);
+		if (statsLength) {
+			(void)_sendRoute(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
+			                       I_DEBUG).set(stats, statsLength));
 		}
-	} else {
-		// sender is a node
-		if (type == I_REGISTRATION_REQUEST) {
+#endif
+	}
+#endif
+	return true;
+}
+
+bool _processInternalRegistrationRequest(void)
+{
 #if defined(MY_GATEWAY_FEATURE)
-			// registration requests are exclusively handled by GW/Controller
+	// registration requests are exclusively handled by GW/Controller
 #if !defined(MY_REGISTRATION_CONTROLLER)
-			bool approveRegistration;
+	bool approveRegistration;
 
 #if defined(MY_CORE_COMPATIBILITY_CHECK)
-			approveRegistration = (_msg.getByte() >= MY_CORE_MIN_VERSION);
+	approveRegistration = (_msg.getByte() >= MY_CORE_MIN_VERSION);
 #else
-			// auto registration if version compatible
-			approveRegistration = true;
+	// auto registration if version compatible
+	approveRegistration = true;
 #endif
 
 #if (F_CPU>16*1000000ul)
-			// delay for fast GW and slow nodes
-			delay(5);
+	// delay for fast GW and slow nodes
+	deferredReply(5, _msg.getSender(), I_REGISTRATION_RESPONSE, approveRegistration);
+#else
+	(void)_sendRoute(build(_msgTmp, _msg.getSender(), NODE_SENSOR_ID, C_INTERNAL,
+	                       I_REGISTRATION_RESPONSE).set(approveRegistration));
 #endif
-			(void)_sendRoute(build(_msgTmp, _msg.getSender(), NODE_SENSOR_ID, C_INTERNAL,
-			                       I_REGISTRATION_RESPONSE).set(approveRegistration));
 #else
-			return false;	// processing of this request via controller
+	return false;	// processing of this request via controller
 #endif
 #endif
-		} else {
-			return false; // further processing required
-		}
+	return true;
+}
+
+#if !defined(MY_GATEWAY_FEATURE)
+#if !defined(MY_PARENT_NODE_IS_STATIC)
+#define INTERNAL_FIND_PARENT_RESPONSE &transportProcessFindParentResponse
+#else
+#define INTERNAL_FIND_PARENT_RESPONSE NULL
+#endif
+#define INTERNAL_ID_RESPONSE &_processInternalHandled
+#else
+// passed on to the controller
+#define INTERNAL_FIND_PARENT_RESPONSE NULL
+#define INTERNAL_ID_RESPONSE NULL
+#endif
+
+// indexed by internal message type, NULL: not handled, passed on to controller / receive()
+const internalHandlerEntry_t _internalHandlers[] PROGMEM = {
+	{ INTERNAL_FROM_ANY, NULL },											// I_BATTERY_LEVEL
+	{ INTERNAL_FROM_GATEWAY, &_processInternalTime },						// I_TIME
+	{ INTERNAL_FROM_GATEWAY, &_processInternalVersion },					// I_VERSION
+	{ INTERNAL_FROM_ANY, NULL },											// I_ID_REQUEST
+	{ INTERNAL_FROM_BUS, INTERNAL_ID_RESPONSE },							// I_ID_RESPONSE
+	{ INTERNAL_FROM_ANY, NULL },											// I_INCLUSION_MODE
+	{ INTERNAL_FROM_GATEWAY, &_processInternalConfig },						// I_CONFIG
+	{ INTERNAL_FROM_ANY, NULL },											// I_FIND_PARENT_REQUEST
+	{ INTERNAL_FROM_BUS, INTERNAL_FIND_PARENT_RESPONSE },					// I_FIND_PARENT_RESPONSE
+	{ INTERNAL_FROM_ANY, NULL },											// I_LOG_MESSAGE
+	{ INTERNAL_FROM_GATEWAY, &_processInternalHandled },					// I_CHILDREN
+	{ INTERNAL_FROM_ANY, NULL },											// I_SKETCH_NAME
+	{ INTERNAL_FROM_ANY, NULL },											// I_SKETCH_VERSION
+	{ INTERNAL_FROM_GATEWAY, &_processInternalReboot },						// I_REBOOT
+	{ INTERNAL_FROM_ANY, NULL },											// I_GATEWAY_READY
+	{ INTERNAL_FROM_ANY, NULL },											// I_SIGNING_PRESENTATION
+	{ INTERNAL_FROM_ANY, NULL },											// I_NONCE_REQUEST
+	{ INTERNAL_FROM_ANY, NULL },											// I_NONCE_RESPONSE
+	{ INTERNAL_FROM_GATEWAY, &_processInternalHeartbeatRequest },			// I_HEARTBEAT_REQUEST
+	{ INTERNAL_FROM_GATEWAY, &_processInternalPresentation },				// I_PRESENTATION
+	{ INTERNAL_FROM_ANY, NULL },											// I_DISCOVER_REQUEST
+	{ INTERNAL_FROM_ANY, NULL },											// I_DISCOVER_RESPONSE
+	{ INTERNAL_FROM_ANY, NULL },											// I_HEARTBEAT_RESPONSE
+	{ INTERNAL_FROM_ANY, NULL },											// I_LOCKED
+	{ INTERNAL_FROM_BUS, &transportProcessPing },							// I_PING
+	{ INTERNAL_FROM_BUS, &transportProcessPong },							// I_PONG
+	{ INTERNAL_FROM_NODE, &_processInternalRegistrationRequest },			// I_REGISTRATION_REQUEST
+	{ INTERNAL_FROM_GATEWAY, &_processInternalRegistrationResponse },		// I_REGISTRATION_RESPONSE
+	{ INTERNAL_FROM_GATEWAY, &_processInternalDebug },						// I_DEBUG
+	{ INTERNAL_FROM_BUS, &transportProcessSignalReportRequest },			// I_SIGNAL_REPORT_REQUEST
+	{ INTERNAL_FROM_BUS, &_processInternalHandled },						// I_SIGNAL_REPORT_REVERSE
+	{ INTERNAL_FROM_ANY, NULL },											// I_SIGNAL_REPORT_RESPONSE
+	{ INTERNAL_FROM_ANY, NULL },											// I_PRE_SLEEP_NOTIFICATION
+	{ INTERNAL_FROM_ANY, NULL },											// I_POST_SLEEP_NOTIFICATION
+	{ INTERNAL_FROM_ANY, NULL }												// I_VALUE_AGE
+};
+
+static_assert(sizeof(_internalHandlers) / sizeof(_internalHandlers[0]) == I_VALUE_AGE + 1,
+              "_internalHandlers must have one entry per internal message type");
+
+bool _processInternalCoreMessage(const bool fromBus)
+{
+	const uint8_t type = _msg.getType();
+	if (type >= sizeof(_internalHandlers) / sizeof(_internalHandlers[0])) {
+		return false; // further processing required
+	}
+	const internalHandler_t handler = reinterpret_cast<internalHandler_t>(pgm_read_ptr(
+	                                      &_internalHandlers[type].handler));
+	if (!handler) {
+		return false; // further processing required
 	}
-	return true; // if not GW or no further processing required
+	const uint8_t from = pgm_read_byte(&_internalHandlers[type].from);
+	const bool fromGateway = (_msg.getSender() == GATEWAY_ADDRESS);
+	if ((from == INTERNAL_FROM_GATEWAY && !fromGateway) || (from == INTERNAL_FROM_NODE && fromGateway) ||
+	        (from == INTERNAL_FROM_BUS && !fromBus)) {
+		return false; // further processing required
+	}
+	return handler();
 }
 
 
@@ -543,25 +748,7 @@ void wait(const uint32_t waitingMS)
 
 bool wait(const uint32_t waitingMS, const mysensors_command_t cmd)
 {
-#if defined(MY_DEBUG_VERBOSE_CORE)
-	if (waitLock) {
-		CORE_DEBUG(PSTR("!MCO:WAI:RC=%" PRIu8 "\n"), waitLock);	// recursive call detected
-	}
-	waitLock++;
-#endif
-	const uint32_t enteringMS = hwMillis();
-	// invalidate cmd
-	//_msg.setCommand(!cmd);
-	_msg.setCommand(C_INVALID_7);
-	bool expectedResponse = false;
-	while ((hwMillis() - enteringMS < waitingMS) && !expectedResponse) {
-		_process();
-		expectedResponse = (_msg.getCommand() == cmd);
-	}
-#if defined(MY_DEBUG_VERBOSE_CORE)
-	waitLock--;
-#endif
-	return expectedResponse;
+	return wait(waitingMS, cmd, PENDING_ANY);
 }
 
 bool wait(const uint32_t waitingMS, const mysensors_command_t cmd, const uint8_t msgType)
@@ -573,14 +760,14 @@ bool wait(const uint32_t waitingMS, const mysensors_command_t cmd, const uint8_t
 	waitLock++;
 #endif
 	const uint32_t enteringMS = hwMillis();
-	// invalidate cmd
-	//_msg.setCommand(!cmd);
-	_msg.setCommand(C_INVALID_7);
+	// matched in the receive path, messages received in the same _process() pass are not missed
+	const uint8_t handle = pendingRequestWait(cmd, msgType, waitingMS);
 	bool expectedResponse = false;
-	while ( (hwMillis() - enteringMS < waitingMS) && !expectedResponse ) {
+	while ((hwMillis() - enteringMS < waitingMS) && !expectedResponse) {
 		_process();
-		expectedResponse = (_msg.getCommand() == cmd && _msg.getType() == msgType);
+		expectedResponse = pendingRequestPoll(handle, cmd, msgType);
 	}
+	(void)pendingRequestRelease(handle);
 #if defined(MY_DEBUG_VERBOSE_CORE)
 	waitLock--;
 #endif
@@ -596,6 +783,33 @@ void doYield(void)
 #endif
 }
 
+uint8_t getBusLoad(void)
+{
+#if defined(MY_SENSOR_NETWORK)
+	return transportHALGetBusLoad();
+#else
+	return 0;
+#endif
+}
+
+uint32_t getBusLoadInterval(const uint32_t intervalMS)
+{
+	return busLoadHandler(getBusLoad(), intervalMS);
+}
+
+#if !defined(MY_BUS_LOAD_HANDLER)
+uint32_t busLoadHandler(const uint8_t load, const uint32_t intervalMS)
+{
+	if (load < MY_BUS_LOAD_HIGH_PERCENT) {
+		return intervalMS;
+	}
+	// 0..48 steps of 1/16 interval, i.e. up to 3 intervals extra at 100% load
+	const uint8_t steps = 48u * (load - MY_BUS_LOAD_HIGH_PERCENT) / (100u - MY_BUS_LOAD_HIGH_PERCENT);
+	const uint32_t jitterMS = (hwMillis() + getNodeId() * 97u) % (intervalMS / 8 + 1);
+	return intervalMS + (intervalMS / 16) * steps + jitterMS;
+}
+#endif
+
 #if !defined(MY_SLEEP_HANDLER)
 void sleepHandler(bool sleep)
 {
@@ -613,7 +827,14 @@ int8_t _sleep(const uint32_t sleepingMS, const bool smartSleep, const uint8_t in
 	           interrupt1, mode1, interrupt2, mode2);
 	// repeater feature: sleeping not possible
 #if defined(MY_REPEATER_FEATURE)
-	
+	(void)smartSleep;
+	(void)interrupt1;
+	(void)mode1;
+	(void)interrupt2;
+	(void)mode2;
+
+	CORE_DEBUG(PSTR("!MCO:SLP:REP\n"));	// sleeping not possible, repeater feature enabled
+	return MY_SLEEP_NOT_POSSIBLE;
 #else
 	uint32_t sleepingTimeMS = sleepingMS;
 #if defined(MY_SENSOR_NETWORK)
@@ -654,6 +875,8 @@ int8_t _sleep(const uint32_t sleepingMS, const bool smartSleep, const uint8_t in
 #endif // MY_SENSOR_NETWORK
 
 #if defined(MY_SENSOR_NETWORK)
+	// pending replies would be lost while the transport is down
+	deferredProcess(true);
 	transportDisable();
 #endif
 	setIndication(INDICATION_SLEEP);
@@ -668,18 +891,43 @@ int8_t _sleep(const uint32_t sleepingMS, const bool smartSleep, const uint8_t in
 	// Call the sleep handler to turn off peripherals optimally
 	sleepHandler(true);
 
+	uint8_t wakeInterrupt1 = interrupt1;
+	uint8_t wakeMode1 = mode1;
+	uint8_t wakeInterrupt2 = interrupt2;
+	uint8_t wakeMode2 = mode2;
+#if defined(MY_CAN_WAKE_ON_BUS)
+	// bus activity asserts the CAN interrupt pin (active low), use it as wake up source if one is left
+	if (digitalPinToInterrupt(CAN_INT) == NOT_AN_INTERRUPT) {
+		CORE_DEBUG(PSTR("!MCO:SLP:CAN NO IRQ\n"));	// CAN_INT is not an external interrupt pin
+	} else if (wakeInterrupt1 == INTERRUPT_NOT_DEFINED) {
+		wakeInterrupt1 = digitalPinToInterrupt(CAN_INT);
+		wakeMode1 = LOW;
+	} else if (wakeInterrupt2 == INTERRUPT_NOT_DEFINED) {
+		wakeInterrupt2 = digitalPinToInterrupt(CAN_INT);
+		wakeMode2 = LOW;
+	} else {
+		CORE_DEBUG(PSTR("!MCO:SLP:CAN NO IRQ\n"));	// both interrupts in use by the sketch
+	}
+#endif
+
 	int8_t result = MY_SLEEP_NOT_POSSIBLE;	// default
-	if (interrupt1 != INTERRUPT_NOT_DEFINED && interrupt2 != INTERRUPT_NOT_DEFINED) {
+	if (wakeInterrupt1 != INTERRUPT_NOT_DEFINED && wakeInterrupt2 != INTERRUPT_NOT_DEFINED) {
 		// both IRQs
-		result = hwSleep(interrupt1, mode1, interrupt2, mode2, sleepingTimeMS);
-	} else if (interrupt1 != INTERRUPT_NOT_DEFINED && interrupt2 == INTERRUPT_NOT_DEFINED) {
+		result = hwSleep(wakeInterrupt1, wakeMode1, wakeInterrupt2, wakeMode2, sleepingTimeMS);
+	} else if (wakeInterrupt1 != INTERRUPT_NOT_DEFINED && wakeInterrupt2 == INTERRUPT_NOT_DEFINED) {
 		// one IRQ
-		result = hwSleep(interrupt1, mode1, sleepingTimeMS);
-	} else if (interrupt1 == INTERRUPT_NOT_DEFINED && interrupt2 == INTERRUPT_NOT_DEFINED) {
+		result = hwSleep(wakeInterrupt1, wakeMode1, sleepingTimeMS);
+	} else if (wakeInterrupt1 == INTERRUPT_NOT_DEFINED && wakeInterrupt2 == INTERRUPT_NOT_DEFINED) {
 		// no IRQ
 		result = hwSleep(sleepingTimeMS);
 	}
 
+#if defined(MY_OUTBOX_FEATURE)
+	// millis() stops while sleeping, keep the age of stored readings right
+	if (result != MY_SLEEP_NOT_POSSIBLE && sleepingTimeMS) {
+		outboxSlept(sleepingTimeMS - getSleepRemaining());
+	}
+#endif
 	// Call the sleep handler to turn on peripherals optimally
 	sleepHandler(false);
 
@@ -50,12 +50,14 @@
 * | | MCO | REG | NOT NEEDED																	| No registration needed (i.e. GW)
 * |!| MCO | SND | NODE NOT REG																| Node is not registered, cannot send message
 * | | MCO | PIM | NODE REG=%%d																| Registration response received, registration status (REG)
+* | | MCO | PRE | DEF,LD=%%d																	| Presentation deferred, bus load in percent (LD)
 * |!| MCO | WAI | RC=%%d																			| Recursive call detected in wait(), level (RC)
 * | | MCO | SLP | MS=%%lu,SMS=%%d,I1=%%d,M1=%%d,I2=%%d,M2=%%d	| Sleep node, time (MS), smartSleep (SMS), Int1 (I1), Mode1 (M1), Int2 (I2), Mode2 (M2)
 * | | MCO | SLP | WUP=%%d																			| Node woke-up, reason/IRQ (WUP)
 * |!| MCO | SLP | NTL																					| Sleeping not possible, no time left
 * |!| MCO | SLP | FWUPD																				| Sleeping not possible, FW update ongoing
 * |!| MCO | SLP | REP																					| Sleeping not possible, repeater feature enabled
+* |!| MCO | SLP | CAN NO IRQ																		| Wake on %CAN not possible, CAN_INT is no external interrupt or both interrupts in use
 * |!| MCO | SLP | TNR																					| Transport not ready, attempt to reconnect until timeout (@ref MY_SLEEP_TRANSPORT_RECONNECT_TIMEOUT_MS)
 * | | MCO | NLK | NODE LOCKED. UNLOCK: GND PIN %%d AND RESET	| Node locked during booting, see signing chapter for additional information
 * | | MCO | NLK | TSL																					| Set transport to sleep
@@ -238,6 +240,27 @@ bool request(const uint8_t childSensorId, const uint8_t variableType,
  */
 bool requestTime(const bool requestEcho = false);
 
+/**
+ * Callback of an asynchronous request
+ * @param message Reply, NULL if the request timed out
+ */
+typedef void (*requestCallback_t)(const MyMessage *message);
+
+/**
+ * Requests a value without waiting for the reply. The reply (C_SET of variableType from destination)
+ * is passed to callback from the receive path, several requests can be in flight at the same time
+ * (see @ref MY_PENDING_REQUESTS). The reply is still delivered to receive() as well.
+ *
+ * @param childSensorId  The unique child id for the different sensors connected to this Arduino. 0-254.
+ * @param variableType The variableType to fetch
+ * @param destination The nodeId of other node in radio network
+ * @param timeoutMS Time until callback is called with NULL
+ * @param callback Called once with the reply or NULL, must not call wait() or sleep()
+ * @return true if the request was registered and reached the first stop on its way to destination.
+ */
+bool requestAsync(const uint8_t childSensorId, const uint8_t variableType, const uint8_t destination,
+                  const uint32_t timeoutMS, const requestCallback_t callback);
+
 /**
  * Returns the most recent node configuration received from controller
  */
@@ -301,6 +324,30 @@ bool wait(const uint32_t waitingMS, const mysensors_command_t cmd, const uint8_t
  */
 void doYield(void);
 
+/**
+ * Estimated load of the sensor network bus.
+ * @return bus load in percent, 0 if no sensor network
+ */
+uint8_t getBusLoad(void);
+
+/**
+ * Stretch a periodic send interval according to the current bus load, see busLoadHandler().
+ * Sketches sending in fixed intervals should wait/sleep for the returned time.
+ * @param intervalMS nominal interval in ms
+ * @return interval to use in ms
+ */
+uint32_t getBusLoadInterval(const uint32_t intervalMS);
+
+/**
+ * Bus load policy used by getBusLoadInterval(). Applications can define own policy (@ref MY_BUS_LOAD_HANDLER).
+ * The default stretches the interval linearly up to four times above @ref MY_BUS_LOAD_HIGH_PERCENT and
+ * adds up to 1/8 of the interval as jitter.
+ * @param load bus load in percent
+ * @param intervalMS nominal interval in ms
+ * @return interval to use in ms
+ */
+uint32_t busLoadHandler(const uint8_t load, const uint32_t intervalMS);
+
 /**
  * Sleep handler will be called right before and right after entering sleep mode.
  * Applications can define own handler to optimize powering down peripherals before entering sleep.
@@ -436,10 +483,33 @@ void _begin(void);
 */
 void _process(void);
 /**
-* @brief Processes internal core message
+* @brief Mark work done in the current _process() pass, keeps the Linux loop from sleeping
+*/
+void _processActivity(void);
+/**
+* @brief Processes internal message addressed to this node, dispatched by type via _internalHandlers
+* @param fromBus Received from the sensor network (transport), false for messages from the controller
 * @return True if no further processing required
 */
-bool _processInternalCoreMessage(void);
+bool _processInternalCoreMessage(const bool fromBus);
+/**
+* @brief Internal message handler, called for _msg
+* @return True if no further processing required
+*/
+typedef bool (*internalHandler_t)(void);
+
+#define INTERNAL_FROM_ANY		(0u)	//!< handler applies to messages from any sender
+#define INTERNAL_FROM_GATEWAY	(1u)	//!< handler applies to messages from the gateway only
+#define INTERNAL_FROM_NODE		(2u)	//!< handler applies to messages from nodes only
+#define INTERNAL_FROM_BUS		(3u)	//!< handler applies to messages from any sender received by the transport
+
+/**
+* @brief Entry of the internal message dispatch table (PROGMEM)
+*/
+typedef struct {
+	uint8_t from;				//!< INTERNAL_FROM_*
+	internalHandler_t handler;	//!< NULL: not handled
+} internalHandlerEntry_t;
 /**
 * @brief Puts node to a infinite loop if unrecoverable situation detected
 */
@@ -390,6 +390,17 @@ void transportInitialise(void)
 	transportSwitchSM(stInit);
 }
 
+void transportDisable(void)
+{
+	TRANSPORT_DEBUG(PSTR("TSF:TDI:TSL\n"));	// set transport to sleep
+	transportHALSleep();
+}
+
+void transportReInitialise(void)
+{
+	TRANSPORT_DEBUG(PSTR("TSF:TRI:TSB\n"));	// set transport to standby
+	transportHALStandBy();
+}
 
 bool transportWaitUntilReady(const uint32_t waitingMS)
 {
@@ -524,15 +535,15 @@ bool transportSendRoute(MyMessage &message)
 bool transportWait(const uint32_t waitingMS, const uint8_t cmd, const uint8_t msgType)
 {
 	const uint32_t enterMS = hwMillis();
-	// invalidate msg type
-	_msg.setType(!msgType);
+	const uint8_t handle = pendingRequestWait(cmd, msgType, waitingMS);
 	bool expectedResponse = false;
 	while ((hwMillis() - enterMS < waitingMS) && !expectedResponse) {
 		// process incoming messages
 		transportProcessFIFO();
 		doYield();
-		expectedResponse = (_msg.getCommand() == cmd && _msg.getType() == msgType);
+		expectedResponse = pendingRequestPoll(handle, cmd, msgType);
 	}
+	(void)pendingRequestRelease(handle);
 	return expectedResponse;
 }
 
@@ -560,11 +571,93 @@ uint8_t transportPingNode(const uint8_t targetId)
 	}
 }
 
+bool transportPingNodeAsync(const uint8_t targetId, const requestCallback_t callback)
+{
+	TRANSPORT_DEBUG(PSTR("TSF:PNG:SEND,TO=%" PRIu8 "\n"), targetId);
+	const uint8_t handle = pendingRequestAdd(targetId, PENDING_ANY, C_INTERNAL, I_PONG, 2000, callback);
+	if (handle == PENDING_REQUEST_NONE) {
+		return false;
+	}
+	if (!transportRouteMessage(build(_msgTmp, targetId, NODE_SENSOR_ID, C_INTERNAL,
+	                                 I_PING).set((uint8_t)0x01))) {
+		(void)pendingRequestRelease(handle);
+		return false;
+	}
+	return true;
+}
+
 uint32_t transportGetHeartbeat(void)
 {
 	return transportTimeInState();
 }
 
+#if !defined(MY_GATEWAY_FEATURE) && !defined(MY_PARENT_NODE_IS_STATIC)
+bool transportProcessFindParentResponse(void)
+{
+	if (_transportSM.findingParentNode) {	// only process if find parent active
+		const uint8_t sender = _msg.getSender();
+		// Reply to a I_FIND_PARENT_REQUEST message. Check if the distance is shorter than we already have.
+		uint8_t distance = _msg.getByte();
+		if (isValidDistance(distance)) {
+			distance++;	// Distance to gateway is one more for us w.r.t. parent
+			// update settings if distance shorter or preferred parent found
+			if (((isValidDistance(distance) && distance < _transportConfig.distanceGW) || (!_autoFindParent &&
+			        sender == (uint8_t)MY_PARENT_NODE_ID)) && !_transportSM.preferredParentFound) {
+				// Found a neighbor closer to GW than previously found
+				if (!_autoFindParent && sender == (uint8_t)MY_PARENT_NODE_ID) {
+					_transportSM.preferredParentFound = true;
+					TRANSPORT_DEBUG(PSTR("TSF:MSG:FPAR PREF\n"));	// find parent, preferred parent found
+				}
+				_transportConfig.distanceGW = distance;
+				_transportConfig.parentNodeId = sender;
+				TRANSPORT_DEBUG(PSTR("TSF:MSG:FPAR OK,ID=%" PRIu8 ",D=%" PRIu8 "\n"), _transportConfig.parentNodeId,
+				                _transportConfig.distanceGW);
+			}
+		}
+	} else {
+		TRANSPORT_DEBUG(PSTR("!TSF:MSG:FPAR INACTIVE\n"));	// find parent response received, but inactive
+	}
+	return true; // no further processing required
+}
+#endif
+
+bool transportProcessPing(void)
+{
+	const uint8_t sender = _msg.getSender();
+	TRANSPORT_DEBUG(PSTR("TSF:MSG:PINGED,ID=%" PRIu8 ",HP=%" PRIu8 "\n"), sender,
+	                _msg.getByte()); // node pinged
+#if defined(MY_GATEWAY_FEATURE) && (F_CPU>16000000)
+	// delay for fast GW and slow nodes
+	deferredReply(5, sender, I_PONG, 1);
+#else
+	(void)transportRouteMessage(build(_msgTmp, sender, NODE_SENSOR_ID, C_INTERNAL,
+	                                  I_PONG).set((uint8_t)1));
+#endif
+	return true; // no further processing required
+}
+
+bool transportProcessPong(void)
+{
+	if (_transportSM.pingActive) {
+		_transportSM.pingActive = false;
+		_transportSM.pingResponse = _msg.getByte();
+		TRANSPORT_DEBUG(PSTR("TSF:MSG:PONG RECV,HP=%" PRIu8 "\n"),
+		                _transportSM.pingResponse); // pong received
+	} else {
+		TRANSPORT_DEBUG(PSTR("!TSF:MSG:PONG RECV,INACTIVE\n")); // pong received, but !pingActive
+	}
+	return true; // no further processing required
+}
+
+bool transportProcessSignalReportRequest(void)
+{
+	int16_t value = INVALID_RSSI;
+
+	(void)transportRouteMessage(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
+	                                  I_SIGNAL_REPORT_RESPONSE).set(value));
+	return true; // no further processing required
+}
+
 void transportProcessMessage(void)
 {
 		// receive message
@@ -612,76 +705,13 @@ void transportProcessMessage(void)
 			// send ECHO, use transportSendRoute since ECHO reply is not internal, i.e. if !transportOK do not reply
 			(void)transportSendRoute(_msgTmp);
 		}
+		// complete waits and asynchronous requests expecting this message
+		pendingRequestComplete(_msg);
 		if(!_msg.isEcho()) {
 			// only process if not ECHO
 			if (command == C_INTERNAL) {
-				// Process signing related internal messages			
-#if !defined(MY_GATEWAY_FEATURE)
-				if (type == I_ID_RESPONSE) {
-					return; // no further processing required
-				}
-				if (type == I_FIND_PARENT_RESPONSE) {
-#if !defined(MY_GATEWAY_FEATURE) && !defined(MY_PARENT_NODE_IS_STATIC)
-					if (_transportSM.findingParentNode) {	// only process if find parent active
-						// Reply to a I_FIND_PARENT_REQUEST message. Check if the distance is shorter than we already have.
-						uint8_t distance = _msg.getByte();
-						if (isValidDistance(distance)) {
-							distance++;	// Distance to gateway is one more for us w.r.t. parent
-							// update settings if distance shorter or preferred parent found
-							if (((isValidDistance(distance) && distance < _transportConfig.distanceGW) || (!_autoFindParent &&
-							        sender == (uint8_t)MY_PARENT_NODE_ID)) && !_transportSM.preferredParentFound) {
-								// Found a neighbor closer to GW than previously found
-								if (!_autoFindParent && sender == (uint8_t)MY_PARENT_NODE_ID) {
-									_transportSM.preferredParentFound = true;
-									TRANSPORT_DEBUG(PSTR("TSF:MSG:FPAR PREF\n"));	// find parent, preferred parent found
-								}
-								_transportConfig.distanceGW = distance;
-								_transportConfig.parentNodeId = sender;
-								TRANSPORT_DEBUG(PSTR("TSF:MSG:FPAR OK,ID=%" PRIu8 ",D=%" PRIu8 "\n"), _transportConfig.parentNodeId,
-								                _transportConfig.distanceGW);
-							}
-						}
-					} else {
-						TRANSPORT_DEBUG(PSTR("!TSF:MSG:FPAR INACTIVE\n"));	// find parent response received, but inactive
-					}
-					return; // no further processing required
-#endif
-				}
-#endif // !defined(MY_GATEWAY_FEATURE)
-				// general
-				if (type == I_PING) {
-					TRANSPORT_DEBUG(PSTR("TSF:MSG:PINGED,ID=%" PRIu8 ",HP=%" PRIu8 "\n"), sender,
-					                _msg.getByte()); // node pinged
-#if defined(MY_GATEWAY_FEATURE) && (F_CPU>16000000)
-					// delay for fast GW and slow nodes
-					delay(5);
-#endif
-					(void)transportRouteMessage(build(_msgTmp, sender, NODE_SENSOR_ID, C_INTERNAL,
-					                                  I_PONG).set((uint8_t)1));
-					return; // no further processing required
-				}
-				if (type == I_PONG) {
-					if (_transportSM.pingActive) {
-						_transportSM.pingActive = false;
-						_transportSM.pingResponse = _msg.getByte();
-						TRANSPORT_DEBUG(PSTR("TSF:MSG:PONG RECV,HP=%" PRIu8 "\n"),
-						                _transportSM.pingResponse); // pong received
-					} else {
-						TRANSPORT_DEBUG(PSTR("!TSF:MSG:PONG RECV,INACTIVE\n")); // pong received, but !pingActive
-					}
-					return; // no further processing required
-				}
-				if (type == I_SIGNAL_REPORT_REVERSE) {
-					return; // no further processing required
-				}
-				if (type == I_SIGNAL_REPORT_REQUEST) {
-					int16_t value = INVALID_RSSI;
-
-					(void)transportRouteMessage(build(_msgTmp, GATEWAY_ADDRESS, NODE_SENSOR_ID, C_INTERNAL,
-					                                  I_SIGNAL_REPORT_RESPONSE).set(value));
-					return; // no further processing required
-				}
-				if (_processInternalCoreMessage()) {
+				// table dispatch, see _internalHandlers
+				if (_processInternalCoreMessage(true)) {
 					return; // no further processing required
 				}
 			} else if (command == C_STREAM) {
@@ -693,6 +723,8 @@ void transportProcessMessage(void)
 		}
 
 #if defined(MY_GATEWAY_FEATURE)
+		gatewayCacheUpdate(_msg);
+		gatewayMailboxNotify(_msg);
 		// Hand over message to controller
 		(void)gatewayTransportSend(_msg);
 #endif
@@ -715,10 +747,9 @@ void transportProcessMessage(void)
 #if !defined(MY_GATEWAY_FEATURE)
 			if (type == I_DISCOVER_REQUEST) {
 				if (sender == _transportConfig.parentNodeId) {
-					// random wait to minimize collisions
-					delay(hwMillis() & 0x3ff);
-					(void)transportRouteMessage(build(_msgTmp, sender, NODE_SENSOR_ID, C_INTERNAL,
-					                                  I_DISCOVER_RESPONSE).set(_transportConfig.parentNodeId));
+					// random wait to minimize collisions, keep receiving meanwhile
+					deferredReply(hwMillis() & 0x3ff, sender, I_DISCOVER_RESPONSE,
+					              _transportConfig.parentNodeId);
 					// no return here (for fwd if repeater)
 				}
 			}
@@ -772,6 +803,7 @@ void transportProcessFIFO(void)
 		// transport not active, no further processing required
 		return;
 	}
+	PROFILE_START(PROFILE_TRANSPORT_FIFO);
 
 #if defined(MY_TRANSPORT_SANITY_CHECK)
 	if (hwMillis() - _lastSanityCheck > MY_TRANSPORT_SANITY_CHECK_INTERVAL_MS) {
@@ -784,6 +816,7 @@ void transportProcessFIFO(void)
 	uint8_t _processedMessages = MAX_SUBSEQ_MSGS;
 	// process all msgs in FIFO or counter exit
 	while (transportHALDataAvailable() && _processedMessages--) {
+		_processActivity();
 		transportProcessMessage();
 	}
 #if defined(MY_OTA_FIRMWARE_FEATURE)
@@ -792,6 +825,7 @@ void transportProcessFIFO(void)
 		firmwareOTAUpdateRequest();
 	}
 #endif
+	PROFILE_END(PROFILE_TRANSPORT_FIFO);
 }
 
 bool transportSendWrite(const uint8_t to, MyMessage &message)
@@ -203,8 +203,8 @@
 #include "hal/transport/MyTransportHAL.h"
 
 #ifndef MY_TRANSPORT_MAX_TX_FAILURES
-#if defined(MY_REPEATER_FEATURE)
-#define MY_TRANSPORT_MAX_TX_FAILURES	(10u)		//!< search for a new parent node after this many transmission failures, higher threshold for repeating nodes
+#if defined(MY_REPEATER_FEATURE) || defined(MY_CAN)
+#define MY_TRANSPORT_MAX_TX_FAILURES	(10u)		//!< search for a new parent node after this many transmission failures, higher threshold for repeating nodes and all %CAN nodes
 #else
 #define MY_TRANSPORT_MAX_TX_FAILURES	(5u)		//!< search for a new parent node after this many transmission failures, lower threshold for non-repeating nodes
 #endif
@@ -390,6 +390,26 @@ void transportProcessFIFO(void);
 */
 void transportProcessMessage(void);
 /**
+* @brief Handle I_FIND_PARENT_RESPONSE, entry of the internal dispatch table
+* @return true, no further processing required
+*/
+bool transportProcessFindParentResponse(void);
+/**
+* @brief Handle I_PING, answer with I_PONG
+* @return true, no further processing required
+*/
+bool transportProcessPing(void);
+/**
+* @brief Handle I_PONG of an active ping
+* @return true, no further processing required
+*/
+bool transportProcessPong(void);
+/**
+* @brief Handle I_SIGNAL_REPORT_REQUEST
+* @return true, no further processing required
+*/
+bool transportProcessSignalReportRequest(void);
+/**
 * @brief Assign node ID
 * @param newNodeId New node ID
 * @return true if node ID is valid and successfully assigned
@@ -410,6 +430,13 @@ bool transportWait(const uint32_t waitingMS, const uint8_t cmd, const uint8_t ms
 */
 uint8_t transportPingNode(const uint8_t targetId);
 /**
+* @brief Ping node without waiting, the I_PONG (hop count in payload) or NULL after 2s is passed to callback
+* @param targetId
+* @param callback Called once, must not call wait() or sleep()
+* @return true if the ping was sent
+*/
+bool transportPingNodeAsync(const uint8_t targetId, const requestCallback_t callback);
+/**
 * @brief Send and route message according to destination
 *
 * This function is used in MyTransport and omits the transport state check, i.e. message can be sent even if transport is not ready
@@ -451,6 +478,14 @@ bool transportWaitUntilReady(const uint32_t waitingMS = 0);
 */
 void transportInitialise(void);
 /**
+* @brief Set transport HW to sleep before node goes to sleep
+*/
+void transportDisable(void);
+/**
+* @brief Resume transport HW after node woke up
+*/
+void transportReInitialise(void);
+/**
 * @brief Process FIFO msg and update SM
 */
 void transportProcess(void);
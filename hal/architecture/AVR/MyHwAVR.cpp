@@ -38,6 +38,8 @@ volatile uint8_t _wakeUp1Interrupt  =
     INVALID_INTERRUPT_NUM;    // Interrupt number for wakeUp1-callback.
 volatile uint8_t _wakeUp2Interrupt  =
     INVALID_INTERRUPT_NUM;    // Interrupt number for wakeUp2-callback.
+volatile uint8_t _idleInterrupt =
+    INVALID_INTERRUPT_NUM;    // Interrupt number for wakeUpIdle-callback.
 
 static uint32_t sleepRemainingMs = 0ul;
 
@@ -63,6 +65,13 @@ void wakeUp2(void)
 	}
 }
 
+void wakeUpIdle(void)
+{
+	// level interrupt fires until the pin is released, detach to return to hwIdle()
+	sleep_disable();
+	detachInterrupt(_idleInterrupt);
+}
+
 inline bool interruptWakeUp(void)
 {
 	return _wokeUpByInterrupt != INVALID_INTERRUPT_NUM;
@@ -233,6 +242,26 @@ uint32_t hwGetSleepRemaining(void)
 	return sleepRemainingMs;
 }
 
+void hwIdle(const uint8_t interrupt)
+{
+	// timer0 keeps running, millis() advances and wakes the CPU at least every 1.024ms
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	if (interrupt == INVALID_INTERRUPT_NUM) {
+		sleep_mode();
+		return;
+	}
+	// as in hwSleep(): an interrupt between attachInterrupt() and sleep_cpu() disables sleep
+	cli();
+	_idleInterrupt = interrupt;
+	clearPendingInterrupt(interrupt);
+	sleep_enable();
+	attachInterrupt(interrupt, wakeUpIdle, LOW);
+	sei();
+	sleep_cpu();
+	sleep_disable();
+	detachInterrupt(interrupt);
+}
+
 
 bool hwUniqueID(unique_id_t *uniqueID)
 {
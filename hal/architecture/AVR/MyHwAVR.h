@@ -44,6 +44,12 @@
 
 #define CRYPTO_LITTLE_ENDIAN
 
+// interrupt driven gateway UART, replaces Serial
+#if defined(MY_GATEWAY_UART)
+#include "drivers/GatewayUART/GatewayUART.h"
+#define MY_SERIALDEVICE GatewaySerial
+#endif
+
 #ifndef MY_SERIALDEVICE
 #define MY_SERIALDEVICE Serial
 #endif
@@ -73,8 +79,8 @@ bool hwInit(void);
 #define hwMillis() millis()
 //#define hwReadConfig(__pos) eeprom_read_byte((const uint8_t *)__pos)
 //#define hwWriteConfig(__pos, __val) eeprom_update_byte((uint8_t *)__pos, (uint8_t)__val)
-//#define hwReadConfigBlock(__buf, __pos, __length) eeprom_read_block((void *)__buf, (const void *)__pos, (uint32_t)__length)
-//#define hwWriteConfigBlock(__buf, __pos, __length) eeprom_update_block((const void *)__buf, (void *)__pos, (uint32_t)__length)
+#define hwReadConfigBlock(__buf, __pos, __length) eeprom_read_block((void *)__buf, (const void *)__pos, (uint32_t)__length)
+#define hwWriteConfigBlock(__buf, __pos, __length) eeprom_update_block((const void *)__buf, (void *)__pos, (uint32_t)__length)
 
 inline void hwRandomNumberInit(void);
 uint32_t hwInternalSleep(uint32_t ms);
@@ -0,0 +1,246 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include "GatewayUART.h"
+
+// RTS is deasserted (high) when the RX ring is 3/4 full and asserted again at 1/2
+#define GATEWAY_UART_RX_STOP (MY_GATEWAY_UART_RX_SIZE - MY_GATEWAY_UART_RX_SIZE / 4)
+#define GATEWAY_UART_RX_RESUME (MY_GATEWAY_UART_RX_SIZE / 2)
+
+// CTS high: controller not ready, TX is paused
+#if defined(MY_GATEWAY_UART_CTS_PIN)
+#define GATEWAY_UART_CTS_READY() (hwDigitalRead(MY_GATEWAY_UART_CTS_PIN) == LOW)
+#else
+#define GATEWAY_UART_CTS_READY() (true)
+#endif
+
+GatewayUART GatewaySerial;
+
+void GatewayUART::begin(const uint32_t baud)
+{
+	// double speed halves the divider, required for 500k and 1M baud at 16MHz
+	uint8_t ucsra = _BV(U2X0);
+	uint16_t ubrr = (F_CPU / 4 / baud - 1) / 2;
+	// 57600 at 16MHz is more accurate in normal mode (same exception as HardwareSerial)
+	if (((F_CPU == 16000000UL) && (baud == 57600)) || (ubrr > 4095)) {
+		ucsra = 0;
+		ubrr = (F_CPU / 8 / baud - 1) / 2;
+	}
+	_rxHead = 0;
+	_rxTail = 0;
+	_txHead = 0;
+	_txTail = 0;
+	_written = false;
+#if defined(MY_GATEWAY_UART_RTS_PIN)
+	_rxStopped = false;
+	hwPinMode(MY_GATEWAY_UART_RTS_PIN, OUTPUT);
+	hwDigitalWrite(MY_GATEWAY_UART_RTS_PIN, LOW);
+#endif
+#if defined(MY_GATEWAY_UART_CTS_PIN)
+	hwPinMode(MY_GATEWAY_UART_CTS_PIN, INPUT);
+#endif
+	UCSR0A = ucsra;
+	UBRR0H = ubrr >> 8;
+	UBRR0L = ubrr;
+	UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);	// 8N1
+	UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+}
+
+void GatewayUART::end(void)
+{
+	flush();
+	UCSR0B &= ~(_BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0) | _BV(UDRIE0));
+	_rxHead = _rxTail;
+}
+
+int GatewayUART::available(void)
+{
+#if defined(MY_GATEWAY_UART_CTS_PIN)
+	// CTS is polled, resume paused TX whenever the gateway looks for input
+	_resumeTx();
+#endif
+	return static_cast<uint8_t>(_rxHead - _rxTail) & GATEWAY_UART_RX_MASK;
+}
+
+int GatewayUART::peek(void)
+{
+	if (_rxHead == _rxTail) {
+		return -1;
+	}
+	return _rxBuffer[_rxTail];
+}
+
+int GatewayUART::read(void)
+{
+	if (_rxHead == _rxTail) {
+		return -1;
+	}
+	const uint8_t data = _rxBuffer[_rxTail];
+	_rxTail = (_rxTail + 1) & GATEWAY_UART_RX_MASK;
+#if defined(MY_GATEWAY_UART_RTS_PIN)
+	if (_rxStopped && (static_cast<uint8_t>(_rxHead - _rxTail) & GATEWAY_UART_RX_MASK) <=
+	        GATEWAY_UART_RX_RESUME) {
+		_rxStopped = false;
+		hwDigitalWrite(MY_GATEWAY_UART_RTS_PIN, LOW);
+	}
+#endif
+	return data;
+}
+
+int GatewayUART::availableForWrite(void)
+{
+	return GATEWAY_UART_TX_MASK - (static_cast<uint8_t>(_txHead - _txTail) & GATEWAY_UART_TX_MASK);
+}
+
+void GatewayUART::flush(void)
+{
+	if (!_written) {
+		return;
+	}
+	while ((_txHead != _txTail) || bit_is_clear(UCSR0A, TXC0)) {
+		if (bit_is_clear(SREG, SREG_I) && bit_is_set(UCSR0B, UDRIE0) && bit_is_set(UCSR0A, UDRE0)) {
+			// interrupts disabled, serve the data register by polling
+			_udreInterrupt();
+		} else {
+			_resumeTx();
+		}
+	}
+}
+
+size_t GatewayUART::write(uint8_t data)
+{
+	_written = true;
+	// ring empty and data register free: bypass the ring, saves the interrupt at high baud rates
+	if ((_txHead == _txTail) && bit_is_set(UCSR0A, UDRE0) && GATEWAY_UART_CTS_READY()) {
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			UDR0 = data;
+			UCSR0A = (UCSR0A & _BV(U2X0)) | _BV(TXC0);
+		}
+		return 1;
+	}
+	const uint8_t head = (_txHead + 1) & GATEWAY_UART_TX_MASK;
+	if (head == _txTail) {
+		_stats.txBlocked++;
+		while (head == _txTail) {
+			if (bit_is_clear(SREG, SREG_I) && bit_is_set(UCSR0A, UDRE0)) {
+				_udreInterrupt();
+			} else {
+				_resumeTx();
+			}
+		}
+	}
+	_txBuffer[_txHead] = data;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		_txHead = head;
+		if (GATEWAY_UART_CTS_READY()) {
+			UCSR0B |= _BV(UDRIE0);
+		}
+	}
+	return 1;
+}
+
+void GatewayUART::getStatistics(gatewayUARTStats_t &stats)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		stats.rxOverruns = _stats.rxOverruns;
+		stats.rxFrameErrors = _stats.rxFrameErrors;
+		stats.rxDropped = _stats.rxDropped;
+		stats.txBlocked = _stats.txBlocked;
+	}
+}
+
+void GatewayUART::_resumeTx(void)
+{
+	if (!GATEWAY_UART_CTS_READY()) {
+		return;
+	}
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		// ISR disables UDRIE when the ring runs empty, check again with interrupts off
+		if (_txHead != _txTail) {
+			UCSR0B |= _BV(UDRIE0);
+		}
+	}
+}
+
+inline void GatewayUART::_rxInterrupt(void)
+{
+	// status is only valid before UDR0 is read
+	const uint8_t status = UCSR0A;
+	const uint8_t data = UDR0;
+	if (status & _BV(DOR0)) {
+		_stats.rxOverruns++;
+	}
+	if (status & _BV(FE0)) {
+		_stats.rxFrameErrors++;
+		return;
+	}
+	const uint8_t head = (_rxHead + 1) & GATEWAY_UART_RX_MASK;
+	if (head == _rxTail) {
+		_stats.rxDropped++;
+		return;
+	}
+	_rxBuffer[_rxHead] = data;
+	_rxHead = head;
+#if defined(MY_GATEWAY_UART_RTS_PIN)
+	if (!_rxStopped && (static_cast<uint8_t>(head - _rxTail) & GATEWAY_UART_RX_MASK) >=
+	        GATEWAY_UART_RX_STOP) {
+		_rxStopped = true;
+		hwDigitalWrite(MY_GATEWAY_UART_RTS_PIN, HIGH);
+	}
+#endif
+}
+
+inline void GatewayUART::_udreInterrupt(void)
+{
+	if (!GATEWAY_UART_CTS_READY()) {
+		// paused until _resumeTx() sees CTS low
+		UCSR0B &= ~_BV(UDRIE0);
+		return;
+	}
+	const uint8_t tail = _txTail;
+	UDR0 = _txBuffer[tail];
+	// clear TXC (write 1), keep double speed setting
+	UCSR0A = (UCSR0A & _BV(U2X0)) | _BV(TXC0);
+	_txTail = (tail + 1) & GATEWAY_UART_TX_MASK;
+	if (_txHead == _txTail) {
+		UCSR0B &= ~_BV(UDRIE0);
+	}
+}
+
+#if defined(USART_RX_vect)
+ISR(USART_RX_vect)
+#elif defined(USART0_RX_vect)
+ISR(USART0_RX_vect)
+#else
+#error No USART0 RX vector, MY_GATEWAY_UART is not supported on this MCU
+#endif
+{
+	GatewaySerial._rxInterrupt();
+}
+
+#if defined(USART_UDRE_vect)
+ISR(USART_UDRE_vect)
+#elif defined(USART0_UDRE_vect)
+ISR(USART0_UDRE_vect)
+#else
+#error No USART0 UDRE vector, MY_GATEWAY_UART is not supported on this MCU
+#endif
+{
+	GatewaySerial._udreInterrupt();
+}
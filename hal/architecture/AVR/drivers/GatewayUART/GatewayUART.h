@@ -0,0 +1,122 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/**
+ * @file GatewayUART.h
+ * @brief Interrupt driven USART0 driver for the serial gateway.
+ *
+ * Replaces HardwareSerial (Serial) with configurable RX/TX rings, optional RTS/CTS flow control
+ * on spare pins and double speed mode. Serial must not be used in the sketch when this driver is
+ * enabled, both own the USART0 interrupt vectors.
+ */
+
+#ifndef GatewayUART_h
+#define GatewayUART_h
+
+#include <Arduino.h>
+
+#ifndef MY_GATEWAY_UART_RX_SIZE
+#define MY_GATEWAY_UART_RX_SIZE (128u)
+#endif
+
+#ifndef MY_GATEWAY_UART_TX_SIZE
+#define MY_GATEWAY_UART_TX_SIZE (128u)
+#endif
+
+#if (MY_GATEWAY_UART_RX_SIZE & (MY_GATEWAY_UART_RX_SIZE - 1)) || (MY_GATEWAY_UART_RX_SIZE > 256u)
+#error MY_GATEWAY_UART_RX_SIZE must be a power of 2 and not larger than 256
+#endif
+
+#if (MY_GATEWAY_UART_TX_SIZE & (MY_GATEWAY_UART_TX_SIZE - 1)) || (MY_GATEWAY_UART_TX_SIZE > 256u)
+#error MY_GATEWAY_UART_TX_SIZE must be a power of 2 and not larger than 256
+#endif
+
+#define GATEWAY_UART_RX_MASK (MY_GATEWAY_UART_RX_SIZE - 1)	//!< RX ring index mask
+#define GATEWAY_UART_TX_MASK (MY_GATEWAY_UART_TX_SIZE - 1)	//!< TX ring index mask
+
+/**
+ * @brief Link counters of the gateway UART
+ */
+typedef struct {
+	uint16_t rxOverruns;	//!< bytes lost in hardware (DOR), RX interrupt served too late
+	uint16_t rxFrameErrors;	//!< bytes discarded because of a framing error
+	uint16_t rxDropped;		//!< bytes discarded because the RX ring was full
+	uint16_t txBlocked;		//!< writes that had to wait for room in the TX ring
+} gatewayUARTStats_t;
+
+/**
+ * @brief Interrupt driven USART0 with ring buffers and optional RTS/CTS
+ */
+class GatewayUART : public Stream
+{
+public:
+	/**
+	 * @brief Configure USART0 for 8N1 and enable the interrupts, uses double speed mode if more accurate
+	 * @param baud Baud rate
+	 */
+	void begin(const uint32_t baud);
+	/**
+	 * @brief Wait for pending TX data and disable USART0
+	 */
+	void end(void);
+	virtual int available(void);
+	virtual int peek(void);
+	virtual int read(void);
+	virtual int availableForWrite(void);
+	virtual void flush(void);
+	virtual size_t write(uint8_t data);
+	using Print::write;
+	/**
+	 * @brief Always ready, for compatibility with HardwareSerial
+	 */
+	operator bool()
+	{
+		return true;
+	}
+	/**
+	 * @brief Consistent copy of the link counters
+	 * @param stats Destination
+	 */
+	void getStatistics(gatewayUARTStats_t &stats);
+	/**
+	 * @brief RX complete interrupt handler
+	 */
+	inline void _rxInterrupt(void);
+	/**
+	 * @brief Data register empty interrupt handler
+	 */
+	inline void _udreInterrupt(void);
+private:
+	void _resumeTx(void);
+	volatile uint8_t _rxHead;
+	volatile uint8_t _rxTail;
+	volatile uint8_t _txHead;
+	volatile uint8_t _txTail;
+	bool _written;
+#if defined(MY_GATEWAY_UART_RTS_PIN)
+	volatile bool _rxStopped;
+#endif
+	volatile gatewayUARTStats_t _stats;
+	uint8_t _rxBuffer[MY_GATEWAY_UART_RX_SIZE];
+	uint8_t _txBuffer[MY_GATEWAY_UART_TX_SIZE];
+};
+
+extern GatewayUART GatewaySerial;	//!< USART0 instance, used as MY_SERIALDEVICE
+
+#endif
@@ -105,6 +105,13 @@ int8_t hwSleep(const uint8_t interrupt1, const uint8_t mode1, const uint8_t inte
                const  uint8_t mode2,
                uint32_t ms);
 
+/**
+ * Halt the CPU until the next interrupt (system tick, pin change, UART), peripherals keep running.
+ * @param interrupt External interrupt attached (LOW level) for the idle period, ends it as soon as the
+ * pin is low, INVALID_INTERRUPT_NUM for none
+ */
+void hwIdle(const uint8_t interrupt);
+
 /**
 * Retrieve unique hardware ID
 * @param uniqueID unique ID
@@ -30,11 +30,49 @@ typedef struct
 	uint8_t age;
 	uint8_t packetId;
 	bool ready;
+#if defined(MY_DEBUG_VERBOSE_CAN)
+	uint16_t spiBytes; // SPI bytes spent receiving this message
+#endif
+#if defined(MY_CAN_REASSEMBLY_STATS)
+	uint16_t firstMs; // first frame received
+#endif
 } CAN_Packet;
 
 // buffer
 CAN_Packet packets[CAN_BUF_SIZE];
 
+#if (CAN_DUP_CACHE_SIZE > 0)
+// recently seen first frame, used to drop duplicated messages before reassembly
+typedef struct
+{
+	uint16_t hash;
+	uint32_t timestamp;
+	uint8_t address;
+	uint8_t packetId; // 0xFF marks an unused entry
+} CAN_SeenFrame;
+
+// recently seen first frames, overwritten round robin
+CAN_SeenFrame seenFrames[CAN_DUP_CACHE_SIZE];
+uint8_t seenFramesNext = 0;
+#endif
+
+// transport statistics
+// zeroed at startup only, re-initialisations after a transport failure keep the history
+canStats_t canStats;
+#if defined(MY_CAN_REASSEMBLY_STATS)
+canAssemblyStats_t canAssemblyStats;
+#endif
+
+// bus load estimation: bits on the bus per bucket, the window slides bucket by bucket
+uint32_t busLoadBits[CAN_LOAD_BUCKETS];
+uint8_t busLoadBucket = 0;
+uint32_t busLoadBucketStart = 0;
+
+// controller error tracking, used to report recovery time.
+bool canInError = false;
+uint32_t canErrorSince = 0;
+uint32_t canLastRecoveryMs = 0;
+
 // filter incoming messages (MCP2515 feature).
 bool _initFilters()
 {
@@ -49,7 +87,7 @@ bool _initFilters()
 	uint8_t err = 0;
 	err += CAN0.setMode(MODE_CONFIG);
 
-	err += CAN0.init_Mask(0, 1, 0x0000FF00);			 // Init first mask. Only destination address will be used to filter messages
+	err += CAN0.init_Mask(0, 1, CAN_ID_TO_MASK);		 // Init first mask. Only destination address will be used to filter messages
 	err += CAN0.init_Filt(0, 1, BROADCAST_ADDRESS << 8); // Init first filter. Accept broadcast messages.
 	err += CAN0.init_Filt(1, 1, _nodeId << 8);			 // Init second filter. Accept messages send to this node.
 	// second mask and filters need to be set. Otherwise all messages would be accepted.
@@ -79,6 +117,15 @@ bool transportInit(void)
 	{
 		_cleanSlot(i);
 	}
+#if defined(MY_CAN_REASSEMBLY_STATS)
+	canAssemblyStats.slotsInUse = 0;
+#endif
+#if (CAN_DUP_CACHE_SIZE > 0)
+	for (uint8_t i = 0; i < CAN_DUP_CACHE_SIZE; i++)
+	{
+		seenFrames[i].packetId = 0xFF;
+	}
+#endif
 	return _initFilters();
 }
 
@@ -92,6 +139,9 @@ void _cleanSlot(uint8_t slot)
 	packets[slot].age = 0;
 	packets[slot].packetId = 0;
 	packets[slot].ready = false;
+#if defined(MY_DEBUG_VERBOSE_CAN)
+	packets[slot].spiBytes = 0;
+#endif
 }
 
 // find empty slot in buffer
@@ -124,14 +174,14 @@ uint8_t _findCanPacketSlot()
 		}
 	}
 	_cleanSlot(slot);
+	canStats.slotEvictions++;
 	CAN_DEBUG(PSTR("!CAN:RCV:SLOT=%" PRIu8 " message dropped\n"), slot);
 
 	return slot;
 }
 
 // find slot with previous data parts.
-uint8_t _findCanPacketSlot(long unsigned int from, long unsigned int currentPart,
-						   long unsigned int messageId)
+uint8_t _findCanPacketSlot(const uint8_t from, const uint8_t currentPart, const uint8_t messageId)
 {
 	uint8_t slot = CAN_BUF_SIZE;
 	uint8_t i;
@@ -147,36 +197,299 @@ uint8_t _findCanPacketSlot(long unsigned int from, long unsigned int currentPart
 	if (slot == CAN_BUF_SIZE)
 	{
 		CAN_DEBUG(PSTR("!CAN:RCV:proper slot not found\n"));
+#if defined(MY_CAN_REASSEMBLY_STATS)
+		canAssemblyStats.orphanFrames++;
+#endif
 	}
 	return slot;
 }
 
-// from address 8bits (A)
-// to address 8 bits (B)
-// current part number 4 bits (C)
-// total part count 4 bits (D)
-// 3 bits message_id (E)
-// 1 bit require ack (F)
-// 1 bit is ack (G)
-// 1 bit is extended frame (H). (FIXED)
-// 1 bit RTR (Remote Transmission Request) (I) (FIXED)
-// 1 bit SRR (Substitute Remote Request)  (J) (FIXED)
-// header model (32 bits)
-// HIJG FEEE DDDD CCCC BBBB BBBB AAAA AAAA
+// classify controller error state.
+canErrorState_t _getErrorState(const uint8_t eflg)
+{
+	if (eflg & MCP_EFLG_TXBO)
+	{
+		return CAN_STATE_BUS_OFF;
+	}
+	if (eflg & (MCP_EFLG_TXEP | MCP_EFLG_RXEP))
+	{
+		return CAN_STATE_ERROR_PASSIVE;
+	}
+	if (eflg & MCP_EFLG_EWARN)
+	{
+		return CAN_STATE_ERROR_WARNING;
+	}
+	return CAN_STATE_ERROR_ACTIVE;
+}
+
+// minimal re-init: pass through config mode to restart the protocol engine and clear overflow flags.
+// setMode() waits for CANSTAT to report the mode, a controller stuck in a mode fails the recovery.
+// Bit timing and filters are kept, a failed recovery is left to the full re-init of the transport state machine.
+bool _recoverController(void)
+{
+	uint8_t err = 0;
+	err += CAN0.setMode(MODE_CONFIG);
+	err += CAN0.setMode(MCP_NORMAL);
+	err += CAN0.clearRXnOVRFlags();
+	return err == 0;
+}
+
+// check controller error flags, recover from error passive and bus off.
+bool _checkAndRecover(void)
+{
+	if (CAN0.checkError() == CAN_OK)
+	{
+		if (canInError)
+		{
+			// controller recovered on its own
+			canInError = false;
+			canLastRecoveryMs = hwMillis() - canErrorSince;
+			CAN_DEBUG(PSTR("CAN:SAN:REC,MS=%" PRIu32 "\n"), canLastRecoveryMs);
+		}
+		return true;
+	}
+	const uint8_t eflg = CAN0.getError();
+	const canErrorState_t state = _getErrorState(eflg);
+	_updateErrorPeaks();
+	CAN_DEBUG(PSTR("!CAN:SAN:EFLG=%" PRIu8 ",ST=%" PRIu8 ",TEC=%" PRIu8 ",REC=%" PRIu8 "\n"), eflg, state,
+			  CAN0.errorCountTX(), CAN0.errorCountRX());
+	if (eflg & (MCP_EFLG_RX0OVR | MCP_EFLG_RX1OVR))
+	{
+		canStats.rxOverflows++;
+		(void)CAN0.clearRXnOVRFlags();
+	}
+	if (state < CAN_STATE_ERROR_PASSIVE)
+	{
+		// receive buffer overflow only, nothing to recover
+		return true;
+	}
+	if (!canInError)
+	{
+		canInError = true;
+		canErrorSince = hwMillis();
+	}
+	if (!_recoverController() || _getErrorState(CAN0.getError()) >= CAN_STATE_ERROR_PASSIVE)
+	{
+		CAN_DEBUG(PSTR("!CAN:SAN:REC FAIL\n"));
+		return false;
+	}
+	canInError = false;
+	canLastRecoveryMs = hwMillis() - canErrorSince;
+	canStats.recoveries++;
+	CAN_DEBUG(PSTR("CAN:SAN:REC,MS=%" PRIu32 "\n"), canLastRecoveryMs);
+	return true;
+}
+
+// track highest error counters
+void _updateErrorPeaks(void)
+{
+	const uint8_t tec = CAN0.errorCountTX();
+	const uint8_t rec = CAN0.errorCountRX();
+	if (tec > canStats.tecPeak)
+	{
+		canStats.tecPeak = tec;
+	}
+	if (rec > canStats.recPeak)
+	{
+		canStats.recPeak = rec;
+	}
+}
+
+#if defined(MY_CAN_REASSEMBLY_STATS)
+// track locked reassembly slots
+void _updateSlotOccupancy(void)
+{
+	uint8_t inUse = 0;
+	for (uint8_t i = 0; i < CAN_BUF_SIZE; i++)
+	{
+		if (packets[i].locked)
+		{
+			inUse++;
+		}
+	}
+	canAssemblyStats.slotsInUse = inUse;
+	if (inUse > canAssemblyStats.slotsPeak)
+	{
+		canAssemblyStats.slotsPeak = inUse;
+	}
+}
+
+// log2 histogram of reassembly time
+void _accountReassemblyLatency(const uint16_t latencyMs)
+{
+	uint8_t bucket = 0;
+	while (bucket < CAN_LATENCY_BUCKETS - 1 && (latencyMs >> bucket) != 0)
+	{
+		bucket++;
+	}
+	if (canAssemblyStats.latency[bucket] < 0xFFFF)
+	{
+		canAssemblyStats.latency[bucket]++;
+	}
+}
+#endif
+
+// count and clear receive buffer overflows
+void _checkOverflow(void)
+{
+	if (CAN0.getError() & (MCP_EFLG_RX0OVR | MCP_EFLG_RX1OVR))
+	{
+		canStats.rxOverflows++;
+		CAN_DEBUG(PSTR("!CAN:RCV:OVR\n"));
+		(void)CAN0.clearRXnOVRFlags();
+	}
+}
+
+// nominal bit rate
+uint16_t _canBitsPerMs(void)
+{
+	switch (CAN_SPEED)
+	{
+	case CAN_4K096BPS:
+		return 4;
+	case CAN_5KBPS:
+		return 5;
+	case CAN_10KBPS:
+		return 10;
+	case CAN_20KBPS:
+		return 20;
+	case CAN_31K25BPS:
+		return 31;
+	case CAN_33K3BPS:
+		return 33;
+	case CAN_40KBPS:
+		return 40;
+	case CAN_50KBPS:
+		return 50;
+	case CAN_80KBPS:
+		return 80;
+	case CAN_100KBPS:
+		return 100;
+	case CAN_125KBPS:
+		return 125;
+	case CAN_200KBPS:
+		return 200;
+	case CAN_250KBPS:
+		return 250;
+	case CAN_500KBPS:
+		return 500;
+	default:
+		return 1000;
+	}
+}
+
+// worst case length of an extended data frame.
+// SOF up to CRC (54 + 8 * dataLength bits) is stuffed, at most one stuff bit per 4 bits after the first.
+// CRC delimiter, ACK, EOF and interframe space (13 bits) are not stuffed.
+uint8_t _canFrameBits(const uint8_t dataLength)
+{
+	const uint8_t stuffedBits = 54 + 8 * dataLength;
+	return stuffedBits + (stuffedBits - 1) / 4 + 13;
+}
+
+// modelled time on the bus of a message with given length, in us
+uint32_t _canMessageBusTime(const uint8_t length)
+{
+	uint32_t bits = 0;
+	for (uint8_t remaining = length; remaining > 8; remaining -= 8)
+	{
+		bits += _canFrameBits(8);
+	}
+	bits += _canFrameBits(length % 8 ? length % 8 : 8);
+	return bits * 1000 / _canBitsPerMs();
+}
+
+// advance the bus load window to the current time
+void _updateBusLoadWindow(void)
+{
+	const uint32_t bucketMS = CAN_LOAD_WINDOW_MS / CAN_LOAD_BUCKETS;
+	uint8_t i;
+	for (i = 0; i < CAN_LOAD_BUCKETS && hwMillis() - busLoadBucketStart >= bucketMS; i++)
+	{
+		busLoadBucket = (busLoadBucket + 1) % CAN_LOAD_BUCKETS;
+		busLoadBits[busLoadBucket] = 0;
+		busLoadBucketStart += bucketMS;
+	}
+	if (i == CAN_LOAD_BUCKETS)
+	{
+		// idle for a whole window
+		busLoadBucketStart = hwMillis();
+	}
+}
+
+void _accountBusBits(const uint32_t bits)
+{
+	_updateBusLoadWindow();
+	busLoadBits[busLoadBucket] += bits;
+}
+
+// hash over the first frame of a message (djb2).
+uint16_t _hashFrame(const uint8_t *data, const uint8_t length)
+{
+	uint16_t hash = 5381;
+	for (uint8_t i = 0; i < length; i++)
+	{
+		hash = (hash << 5) + hash + data[i];
+	}
+	return hash;
+}
+
+// check first frame against recently seen ones. Unknown frames are remembered.
+bool _isDuplicateFrame(const uint8_t from, const uint8_t messageId, const uint8_t *data,
+					   const uint8_t length)
+{
+#if (CAN_DUP_CACHE_SIZE > 0)
+	const uint16_t hash = _hashFrame(data, length);
+	const uint32_t now = hwMillis();
+	bool duplicate = false;
+	for (uint8_t i = 0; i < CAN_DUP_CACHE_SIZE; i++)
+	{
+		if (seenFrames[i].packetId == 0xFF)
+		{
+			continue;
+		}
+		if (now - seenFrames[i].timestamp >= CAN_DUP_CACHE_TIMEOUT_MS)
+		{
+			seenFrames[i].packetId = 0xFF;
+		}
+		else if (seenFrames[i].address == from)
+		{
+			if (seenFrames[i].packetId == messageId && seenFrames[i].hash == hash)
+			{
+				duplicate = true;
+			}
+			else if (((messageId - seenFrames[i].packetId) & 0x07) >= 4)
+			{
+				// sender is half the id range ahead, expire before the id wraps to this entry
+				seenFrames[i].packetId = 0xFF;
+			}
+		}
+	}
+	if (duplicate)
+	{
+		return true;
+	}
+	seenFrames[seenFramesNext].hash = hash;
+	seenFrames[seenFramesNext].timestamp = now;
+	seenFrames[seenFramesNext].address = from;
+	seenFrames[seenFramesNext].packetId = messageId;
+	seenFramesNext = (seenFramesNext + 1) % CAN_DUP_CACHE_SIZE;
+#else
+	(void)from;
+	(void)messageId;
+	(void)data;
+	(void)length;
+#endif
+	return false;
+}
+
+// identifier layout see MyTransportCAN.h
 long unsigned int _buildHeader(uint8_t messageId, uint8_t totalPartCount, uint8_t currentPartNumber,
 							   uint8_t toAddress, uint8_t fromAddress)
 {
-	long unsigned int header =
-		0x80;					  // set H=1 (FIXED), I=0 (FIXED), J=0 (FIXED), G=0 (To be implemented), F=0 (To be implemented)
-	header += (messageId & 0x07); // set messageId
-	header = header << 4;
-	header += (totalPartCount & 0x0F); // set total part count
-	header = header << 4;
-	header += (currentPartNumber & 0x0F); // set current part number
-	header = header << 8;
-	header += toAddress; // set destination address
-	header = header << 8;
-	header += fromAddress; // set source address
+	// H=1 (FIXED), I=0 (FIXED), J=0 (FIXED), G=0 (To be implemented), F=0 (To be implemented)
+	const long unsigned int header = CAN_ID_BUILD(messageId, totalPartCount, currentPartNumber, toAddress,
+									 fromAddress);
 	CAN_DEBUG(PSTR("CAN:SND:CANH=%" PRIu32 ",ID=%" PRIu8
 				   ",TOTAL=%" PRIu8 ",CURR=%" PRIu8 ",TO=%" PRIu8 ",FROM=%" PRIu8 "\n"),
 			  header, messageId, totalPartCount,
@@ -187,7 +500,7 @@ long unsigned int _buildHeader(uint8_t messageId, uint8_t totalPartCount, uint8_
 bool transportSend(const uint8_t to, const void *data, const uint8_t len, const bool noACK)
 {
 	(void)noACK; // some ack is provided by CAN itself. TODO implement application layer ack.
-	const char *datap = static_cast<char const *>(data);
+	const uint8_t *datap = static_cast<const uint8_t *>(data);
 	// calculate number of frames
 	uint8_t noOfFrames = len / 8;
 	if (len % 8 != 0)
@@ -200,29 +513,17 @@ bool transportSend(const uint8_t to, const void *data, const uint8_t len, const
 	message_id = message_id & 0x07;
 
 	CAN_DEBUG(PSTR("CAN:SND:LN=%" PRIu8 ",NOF=%" PRIu8 "\n"), len, noOfFrames);
+#if defined(MY_DEBUG_VERBOSE_CAN)
+	const uint32_t spiBytesStart = CAN0.getSpiBytes();
+#endif
 	uint8_t currentFrame;
 	for (currentFrame = 0; currentFrame < noOfFrames; currentFrame++)
 	{
-		uint8_t partLen;
-		if (len <= 8)
-		{
-			partLen = len;
-		}
-		else if (currentFrame * 8 <= len)
-		{
-			partLen = 8;
-		}
-		else
-		{
-			partLen = len % 8;
-		}
+		// full frames, remainder in the last one. Receivers still accept padded last frames of older nodes.
+		const uint8_t offset = currentFrame * 8;
+		const uint8_t partLen = (len - offset > 8) ? 8 : len - offset;
 		uint8_t buff[8];
-		uint8_t j = 0;
-		//        memcpy(buff,datap[currentFrame*8],partLen);
-		for (j = 0; j < partLen; j++)
-		{
-			buff[j] = datap[currentFrame * 8 + j];
-		}
+		(void)memcpy(buff, datap + offset, partLen);
 
 		CAN_DEBUG(PSTR("CAN:SND:LN=%" PRIu8 ",DTA0=%" PRIu8 ",DTA1=%" PRIu8 ",DTA2=%" PRIu8 ",DTA3=%" PRIu8
 					   ",DTA4=%" PRIu8 ",DTA5=%" PRIu8 ",DTA6=%" PRIu8 ",DTA7=%" PRIu8 "\n"),
@@ -230,26 +531,42 @@ bool transportSend(const uint8_t to, const void *data, const uint8_t len, const
 				  buff[1],
 				  buff[2], buff[3], buff[4], buff[5], buff[6], buff[7]);
 
+		const uint32_t sendStartUS = micros();
 		byte sndStat = CAN0.sendMsgBuf(_buildHeader(message_id, noOfFrames, currentFrame, to, _nodeId),
 									   partLen, buff);
+		// waiting for the bus (lost arbitration, retransmissions) is load caused by frames we do not see
+		const uint32_t elapsedBits = (micros() - sendStartUS) * _canBitsPerMs() / 1000;
+		const uint8_t frameBits = _canFrameBits(partLen);
+		_accountBusBits(elapsedBits > frameBits ? elapsedBits : frameBits);
 		if (sndStat == CAN_OK)
 		{
+			canStats.txFrames++;
 			CAN_DEBUG(PSTR("CAN:SND:OK cFrame:%" PRIu8 "\n"), currentFrame);
-			if (currentFrame == noOfFrames - 1)
-				return true;
 		}
 		else if (sndStat == CAN_SENDMSGTIMEOUT)
 		{
 			CAN_DEBUG(PSTR("!CAN:SND:TIMO:sndStat%" PRIu8 "\n"), sndStat);
-			if (currentFrame == noOfFrames - 1)
-				return true;
+			canStats.txTimeouts++;
+			// frame still pending, check for error passive / bus off and recover right away
+			(void)_checkAndRecover();
 		}
 		else
 		{
 			CAN_DEBUG(PSTR("!CAN:SND:FAIL:sndStat%" PRIu8 "\n"), sndStat);
+			(void)_checkAndRecover();
 			return false;
 		}
 	}
+	// per message cost: SPI bytes, frames and modelled bus time
+	CAN_DEBUG(PSTR("CAN:SND:COST,SPI=%" PRIu32 ",FR=%" PRIu8 ",BT=%" PRIu32 "\n"),
+			  CAN0.getSpiBytes() - spiBytesStart, noOfFrames, _canMessageBusTime(len));
+	return true;
+}
+
+bool transportInterruptPending(void)
+{
+	// CAN_INT is held low while a frame waits in a receive buffer or an error flag is set
+	return !hwDigitalRead(CAN_INT);
 }
 
 bool transportDataAvailable(void)
@@ -257,25 +574,48 @@ bool transportDataAvailable(void)
 	if (!hwDigitalRead(CAN_INT))
 	{ // If CAN_INT pin is low, read receive buffer
 		CAN_DEBUG(PSTR("CAN:CHK:REC\n"));
-		CAN0.readMsgBuf(&rxId, &len, rxBuf); // Read data: len = data length, buf = data byte(s)
-		long unsigned int from = (rxId & 0x000000FF);
-		// cppcheck-suppress unreadVariable
-		long unsigned int to = (rxId & 0x0000FF00) >> 8;
-		long unsigned int currentPart = (rxId & 0x000F0000) >> 16;
-		long unsigned int totalPartCount = (rxId & 0x00F00000) >> 20;
-		long unsigned int messageId = (rxId & 0x07000000) >> 24;
-		CAN_DEBUG(PSTR("CAN:RCV:CANH=%" PRIu32 ",ID=%" PRIu32
-					   ",TOTAL=%" PRIu32 ",CURR=%" PRIu32 ",TO=%" PRIu32 ",FROM=%" PRIu32 "\n"),
+#if defined(MY_DEBUG_VERBOSE_CAN)
+		const uint32_t spiBytesStart = CAN0.getSpiBytes();
+#endif
+		if (CAN0.readMsgBuf(&rxId, &len, rxBuf) != CAN_OK) // Read data: len = data length, buf = data byte(s)
+		{
+			return false;
+		}
+		canStats.rxFrames++;
+		_accountBusBits(_canFrameBits(len));
+		if (!hwDigitalRead(CAN_INT))
+		{
+			// second receive buffer is full as well, the next frame may overflow
+			_checkOverflow();
+		}
+		const uint8_t from = CAN_ID_FROM(rxId);
+		const uint8_t currentPart = CAN_ID_PART(rxId);
+		const uint8_t totalPartCount = CAN_ID_TOTAL(rxId);
+		const uint8_t messageId = CAN_ID_MSG_ID(rxId);
+		CAN_DEBUG(PSTR("CAN:RCV:CANH=%" PRIu32 ",ID=%" PRIu8
+					   ",TOTAL=%" PRIu8 ",CURR=%" PRIu8 ",TO=%" PRIu8 ",FROM=%" PRIu8 "\n"),
 				  rxId, messageId,
 				  totalPartCount,
-				  currentPart, to, from);
+				  currentPart, CAN_ID_TO(rxId), from);
 		uint8_t slot;
 		if (currentPart == 0)
 		{
+			// drop duplicates before a slot is allocated. Following parts of a dropped message do not find a slot.
+			if (_isDuplicateFrame(from, messageId, rxBuf, len))
+			{
+				canStats.duplicates++;
+				CAN_DEBUG(PSTR("!CAN:RCV:DUP,FROM=%" PRIu8 ",ID=%" PRIu8 ",CNT=%" PRIu16 "\n"), from, messageId,
+						  canStats.duplicates);
+				return false;
+			}
 			slot = _findCanPacketSlot();
 			packets[slot].locked = true;
 			packets[slot].packetId = messageId;
 			packets[slot].address = from;
+#if defined(MY_CAN_REASSEMBLY_STATS)
+			packets[slot].firstMs = static_cast<uint16_t>(hwMillis());
+			_updateSlotOccupancy();
+#endif
 		}
 		else
 		{
@@ -286,11 +626,20 @@ bool transportDataAvailable(void)
 			memcpy(packets[slot].data + packets[slot].len, rxBuf, len);
 			packets[slot].lastReceivedPart++;
 			packets[slot].len += len;
+#if defined(MY_DEBUG_VERBOSE_CAN)
+			packets[slot].spiBytes += CAN0.getSpiBytes() - spiBytesStart;
+#endif
 			CAN_DEBUG(PSTR("CAN:RCV:SLOT=%" PRIu8 ",PART=%" PRIu8 "\n"), slot, packets[slot].lastReceivedPart);
 			if (packets[slot].lastReceivedPart == totalPartCount)
 			{
 				packets[slot].ready = true;
+				canStats.rxMessages++;
+#if defined(MY_CAN_REASSEMBLY_STATS)
+				_accountReassemblyLatency(static_cast<uint16_t>(hwMillis()) - packets[slot].firstMs);
+#endif
 				CAN_DEBUG(PSTR("CAN:RCV:SLOT=%" PRIu8 " complete\n"), slot);
+				CAN_DEBUG(PSTR("CAN:RCV:COST,SPI=%" PRIu16 ",FR=%" PRIu8 ",BT=%" PRIu32 "\n"),
+						  packets[slot].spiBytes, packets[slot].lastReceivedPart, _canMessageBusTime(packets[slot].len));
 /* NUR ZUM TESTEN DES SLOT PROBLEMS, muss wieder raus!!!!
 				uint8_t i;
 				for (i = 0; i < CAN_BUF_SIZE; i++)
@@ -339,30 +688,105 @@ uint8_t transportGetAddress(void)
 	return _nodeId;
 }
 
+uint16_t transportGetDuplicateCount(void)
+{
+	return canStats.duplicates;
+}
+
+uint8_t transportGetStatistics(const char selector, void *data)
+{
+	if (selector == 'A')
+	{
+#if defined(MY_CAN_REASSEMBLY_STATS)
+		_updateSlotOccupancy();
+		canAssemblyStats.version = CAN_STATS_VERSION;
+		(void)memcpy(data, &canAssemblyStats, sizeof(canAssemblyStats));
+		return sizeof(canAssemblyStats);
+#else
+		return 0;
+#endif
+	}
+	if (canInitialized)
+	{
+		_updateErrorPeaks();
+		_checkOverflow();
+	}
+	canStats.version = CAN_STATS_VERSION;
+	canStats.lastRecoveryMs = canLastRecoveryMs > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(canLastRecoveryMs);
+	canStats.spiTransactions = CAN0.getSpiCount();
+	(void)memcpy(data, &canStats, sizeof(canStats));
+	return sizeof(canStats);
+}
+
+uint8_t transportGetBusLoad(void)
+{
+	_updateBusLoadWindow();
+	// window covers the complete older buckets and the elapsed part of the current one
+	const uint32_t windowMS = (CAN_LOAD_BUCKETS - 1) * (CAN_LOAD_WINDOW_MS / CAN_LOAD_BUCKETS) +
+							  (hwMillis() - busLoadBucketStart);
+	uint32_t bits = 0;
+	for (uint8_t i = 0; i < CAN_LOAD_BUCKETS; i++)
+	{
+		bits += busLoadBits[i];
+	}
+	const uint32_t load = bits * 100 / (windowMS * _canBitsPerMs());
+	return load > 100 ? 100 : static_cast<uint8_t>(load);
+}
+
 bool transportSanityCheck(void)
 {
-	// not implemented yet
-	return true;
+	if (!canInitialized)
+	{
+		return false;
+	}
+	return _checkAndRecover();
 }
 
 void transportPowerDown(void)
 {
-	// Nothing to shut down here
+	// no power pin, sleep mode is the lowest power state of the MCP2515
+	transportSleep();
 }
 
 void transportPowerUp(void)
 {
-	// not implemented
+	transportStandBy();
 }
 
 void transportSleep(void)
 {
-	// not implemented
+	if (!canInitialized)
+	{
+		return;
+	}
+#if defined(MY_CAN_WAKE_ON_BUS)
+	// bus activity sets WAKIF and asserts CAN_INT
+	(void)CAN0.setSleepWakeup(1);
+#endif
+	if (CAN0.setMode(MCP_SLEEP) != CAN_OK)
+	{
+		CAN_DEBUG(PSTR("!CAN:SLP:FAIL\n"));
+		return;
+	}
+	CAN_DEBUG(PSTR("CAN:SLP\n"));
 }
 
 void transportStandBy(void)
 {
-	// not implemented
+	if (!canInitialized)
+	{
+		return;
+	}
+	// back to normal mode, bit timing and filters survive sleep. A bus wake up leaves the controller in
+	// listen only mode, the frame that woke it is lost.
+	(void)CAN0.setSleepWakeup(0);
+	if (CAN0.setMode(MCP_NORMAL) != CAN_OK)
+	{
+		CAN_DEBUG(PSTR("!CAN:STB:FAIL\n"));
+		(void)transportInit();
+		return;
+	}
+	CAN_DEBUG(PSTR("CAN:STB\n"));
 }
 
 int16_t transportGetSendingRSSI(void)
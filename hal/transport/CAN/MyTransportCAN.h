@@ -1,3 +1,70 @@
+// 29 bit extended identifier, shared by all CAN backends (MCP2515, SocketCAN, ...)
+// from address 8bits (A)
+// to address 8 bits (B)
+// current part number 4 bits (C)
+// total part count 4 bits (D)
+// 3 bits message_id (E)
+// 1 bit require ack (F)
+// 1 bit is ack (G)
+// 1 bit is extended frame (H). (FIXED), same position as CAN_EFF_FLAG of SocketCAN
+// 1 bit RTR (Remote Transmission Request) (I) (FIXED)
+// 1 bit SRR (Substitute Remote Request)  (J) (FIXED)
+// header model (32 bits)
+// HIJG FEEE DDDD CCCC BBBB BBBB AAAA AAAA
+#define CAN_ID_EXTENDED (0x80000000UL)	// H
+#define CAN_ID_TO_MASK (0x0000FF00UL)	// B, used for acceptance filters
+#define CAN_ID_BUILD(__msgId, __total, __part, __to, __from) (CAN_ID_EXTENDED | \
+		(static_cast<uint32_t>((__msgId) & 0x07) << 24) | (static_cast<uint32_t>((__total) & 0x0F) << 20) | \
+		(static_cast<uint32_t>((__part) & 0x0F) << 16) | (static_cast<uint16_t>(__to) << 8) | \
+		static_cast<uint8_t>(__from))
+// byte wise decode, avoids 32 bit shifts on 8 bit targets
+#define CAN_ID_FROM(__id) (static_cast<uint8_t>(__id))
+#define CAN_ID_TO(__id) (static_cast<uint8_t>((__id) >> 8))
+#define CAN_ID_PART(__id) (static_cast<uint8_t>((__id) >> 16) & 0x0F)
+#define CAN_ID_TOTAL(__id) (static_cast<uint8_t>((__id) >> 16) >> 4)
+#define CAN_ID_MSG_ID(__id) (static_cast<uint8_t>((__id) >> 24) & 0x07)
+
+// controller error state, derived from EFLG
+typedef enum {
+	CAN_STATE_ERROR_ACTIVE,		// TEC and REC below 96
+	CAN_STATE_ERROR_WARNING,	// TEC or REC at least 96
+	CAN_STATE_ERROR_PASSIVE,	// TEC or REC at least 128
+	CAN_STATE_BUS_OFF			// TEC above 255
+} canErrorState_t;
+
+#define CAN_STATS_VERSION (1u)	// layout version of canStats_t
+
+// transport statistics, sent as binary (little endian) I_DEBUG payload
+typedef struct {
+	uint8_t version;			// CAN_STATS_VERSION
+	uint8_t tecPeak;			// highest transmit error counter seen
+	uint8_t recPeak;			// highest receive error counter seen
+	uint8_t recoveries;			// recoveries from error passive / bus off
+	uint16_t txFrames;			// frames sent
+	uint16_t rxFrames;			// frames received
+	uint16_t rxMessages;		// messages reassembled
+	uint16_t slotEvictions;		// incomplete messages evicted from reassembly buffer
+	uint16_t txTimeouts;		// frames not confirmed within driver timeout
+	uint16_t rxOverflows;		// RX0OVR / RX1OVR events
+	uint16_t duplicates;		// duplicated messages dropped
+	uint16_t lastRecoveryMs;	// duration of last recovery (saturated)
+	uint32_t spiTransactions;	// SPI transactions to the MCP2515
+} __attribute__((packed)) canStats_t;
+
+#define CAN_LOAD_BUCKETS (4u)	// number of buckets in the bus load window
+
+#define CAN_LATENCY_BUCKETS (8u)	// reassembly latency histogram buckets
+
+// reassembly statistics, sent as binary (little endian) I_DEBUG payload
+typedef struct {
+	uint8_t version;						// CAN_STATS_VERSION
+	uint8_t slotsInUse;						// slots currently locked
+	uint8_t slotsPeak;						// highest number of locked slots seen
+	uint8_t reserved;						// reserved
+	uint16_t orphanFrames;					// continuation frames without matching slot
+	uint16_t latency[CAN_LATENCY_BUCKETS];	// first to last frame: <1, <2, <4 ... <64, >=64 ms
+} __attribute__((packed)) canAssemblyStats_t;
+
 bool _initFilters();
 bool transportInit(void);
 
@@ -5,19 +72,55 @@ void _cleanSlot(uint8_t slot);
 
 uint8_t _findCanPacketSlot();
 
-uint8_t _findCanPacketSlot(long unsigned int from, long unsigned int currentPart,
-                           long unsigned int messageId);
+uint8_t _findCanPacketSlot(const uint8_t from, const uint8_t currentPart, const uint8_t messageId);
+
+uint16_t _hashFrame(const uint8_t *data, const uint8_t length);
+
+bool _isDuplicateFrame(const uint8_t from, const uint8_t messageId, const uint8_t *data,
+                       const uint8_t length);
+
+canErrorState_t _getErrorState(const uint8_t eflg);
+
+bool _recoverController(void);
+
+bool _checkAndRecover(void);
+
+void _updateErrorPeaks(void);
+
+void _checkOverflow(void);
+
+void _updateSlotOccupancy(void);
+
+void _accountReassemblyLatency(const uint16_t latencyMs);
+
+uint16_t _canBitsPerMs(void);
+
+uint8_t _canFrameBits(const uint8_t dataLength);
+
+uint32_t _canMessageBusTime(const uint8_t length);
+
+void _updateBusLoadWindow(void);
+
+void _accountBusBits(const uint32_t bits);
 
 bool transportSend(const uint8_t to, const void* data, const uint8_t len, const bool noACK);
 
 bool transportDataAvailable(void);
 
+bool transportInterruptPending(void);
+
 uint8_t transportReceive(void* data);
 
 void transportSetAddress(const uint8_t address);
 
 uint8_t transportGetAddress(void);
 
+uint16_t transportGetDuplicateCount(void);
+
+uint8_t transportGetStatistics(const char selector, void* data);
+
+uint8_t transportGetBusLoad(void);
+
 bool transportSanityCheck(void);
 
 void transportPowerDown(void);
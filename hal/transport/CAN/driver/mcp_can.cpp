@@ -23,7 +23,12 @@
 */
 #include "mcp_can.h"
 
-#define spi_readwrite SPI.transfer
+#if defined(MY_DEBUG_VERBOSE_CAN)
+// bytes are only counted for the per message cost output of the transport
+#define spi_readwrite(data) (m_nSpiBytes++, SPI.transfer(data))
+#else
+#define spi_readwrite(data) SPI.transfer(data)
+#endif
 #define spi_read() spi_readwrite(0x00)
 
 /*********************************************************************************************************
@@ -33,6 +38,7 @@
 void MCP_CAN::mcp2515_reset(void)
 {
 	SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));
+	m_nSpiCount++;
 	MCP2515_SELECT();
 	spi_readwrite(MCP_RESET);
 	MCP2515_UNSELECT();
@@ -49,6 +55,7 @@ INT8U MCP_CAN::mcp2515_readRegister(const INT8U address)
 	INT8U ret;
 
 	SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));
+	m_nSpiCount++;
 	MCP2515_SELECT();
 	spi_readwrite(MCP_READ);
 	spi_readwrite(address);
@@ -67,6 +74,7 @@ void MCP_CAN::mcp2515_readRegisterS(const INT8U address, INT8U values[], const I
 {
 	INT8U i;
 	SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));
+	m_nSpiCount++;
 	MCP2515_SELECT();
 	spi_readwrite(MCP_READ);
 	spi_readwrite(address);
@@ -86,6 +94,7 @@ void MCP_CAN::mcp2515_readRegisterS(const INT8U address, INT8U values[], const I
 void MCP_CAN::mcp2515_setRegister(const INT8U address, const INT8U value)
 {
 	SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));
+	m_nSpiCount++;
 	MCP2515_SELECT();
 	spi_readwrite(MCP_WRITE);
 	spi_readwrite(address);
@@ -102,6 +111,7 @@ void MCP_CAN::mcp2515_setRegisterS(const INT8U address, const INT8U values[], co
 {
 	INT8U i;
 	SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));
+	m_nSpiCount++;
 	MCP2515_SELECT();
 	spi_readwrite(MCP_WRITE);
 	spi_readwrite(address);
@@ -121,6 +131,7 @@ void MCP_CAN::mcp2515_setRegisterS(const INT8U address, const INT8U values[], co
 void MCP_CAN::mcp2515_modifyRegister(const INT8U address, const INT8U mask, const INT8U data)
 {
 	SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));
+	m_nSpiCount++;
 	MCP2515_SELECT();
 	spi_readwrite(MCP_BITMOD);
 	spi_readwrite(address);
@@ -138,6 +149,7 @@ INT8U MCP_CAN::mcp2515_readStatus(void)
 {
 	INT8U i;
 	SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));
+	m_nSpiCount++;
 	MCP2515_SELECT();
 	spi_readwrite(MCP_READ_STATUS);
 	i = spi_read();
@@ -162,16 +174,15 @@ INT8U MCP_CAN::setMode(const INT8U opMode)
 *********************************************************************************************************/
 INT8U MCP_CAN::mcp2515_setCANCTRL_Mode(const INT8U newmode)
 {
-	INT8U i;
-
 	mcp2515_modifyRegister(MCP_CANCTRL, MODE_MASK, newmode);
 
-	i = mcp2515_readRegister(MCP_CANCTRL);
-	i &= MODE_MASK;
-
-	if (i == newmode) {
-		return MCP2515_OK;
-	}
+	// CANCTRL holds the request, CANSTAT the mode entered, e.g. after the frame on the bus
+	const unsigned long start = millis();
+	do {
+		if ((mcp2515_readRegister(MCP_CANSTAT) & MODE_MASK) == newmode) {
+			return MCP2515_OK;
+		}
+	} while (millis() - start < MODE_TIMEOUT_MS);
 
 	return MCP2515_FAIL;
 }
@@ -755,6 +766,8 @@ INT8U MCP_CAN::mcp2515_getNextFreeTXBuf(INT8U
 MCP_CAN::MCP_CAN(INT8U _CS)
 {
 	MCPCS = _CS;
+	m_nSpiCount = 0;
+	m_nSpiBytes = 0;
 	MCP2515_UNSELECT();
 	pinMode(MCPCS, OUTPUT);
 }
@@ -1229,6 +1242,28 @@ INT8U MCP_CAN::errorCountTX(void)
 	return mcp2515_readRegister(MCP_TEC);
 }
 
+/*********************************************************************************************************
+** Function name:           clearRXnOVRFlags
+** Descriptions:            Clears the receive buffer overflow flags in EFLG
+*********************************************************************************************************/
+INT8U MCP_CAN::clearRXnOVRFlags(void)
+{
+	mcp2515_modifyRegister(MCP_EFLG, MCP_EFLG_RX0OVR | MCP_EFLG_RX1OVR, 0);
+	return CAN_OK;
+}
+
+/*********************************************************************************************************
+** Function name:           setSleepWakeup
+** Descriptions:            Enables or disables the wake up interrupt (WAKIE), clears a pending WAKIF
+*********************************************************************************************************/
+INT8U MCP_CAN::setSleepWakeup(INT8U enable)
+{
+	mcp2515_modifyRegister(MCP_CANINTF, MCP_WAKIF, 0);
+	/* WAKIE in CANINTE has the same bit position as WAKIF in CANINTF */
+	mcp2515_modifyRegister(MCP_CANINTE, MCP_WAKIF, enable ? MCP_WAKIF : 0);
+	return CAN_OK;
+}
+
 /*********************************************************************************************************
 ** Function name:           mcp2515_enOneShotTX
 ** Descriptions:            Enables one shot transmission mode
@@ -1273,6 +1308,25 @@ INT8U MCP_CAN::abortTX(void)
 	}
 }
 
+/*********************************************************************************************************
+** Function name:           getSpiCount
+** Descriptions:            Returns the number of SPI transactions since start up
+*********************************************************************************************************/
+INT32U MCP_CAN::getSpiCount(void)
+{
+	return m_nSpiCount;
+}
+
+/*********************************************************************************************************
+** Function name:           getSpiBytes
+** Descriptions:            Returns the number of bytes transferred over SPI since start up,
+**                          counted with MY_DEBUG_VERBOSE_CAN only
+*********************************************************************************************************/
+INT32U MCP_CAN::getSpiBytes(void)
+{
+	return m_nSpiBytes;
+}
+
 /*********************************************************************************************************
 ** Function name:           setGPO
 ** Descriptions:            Public function, Checks for r
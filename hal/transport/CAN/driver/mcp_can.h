@@ -40,6 +40,8 @@ private:
 	INT8U m_nfilhit;                                                  // The number of the filter that matched the message
 	INT8U MCPCS;                                                      // Chip Select pin number
 	INT8U mcpMode;                                                    // Mode to return to after configurations are performed.
+	INT32U m_nSpiCount;                                               // Number of SPI transactions
+	INT32U m_nSpiBytes;                                               // Number of SPI bytes transferred
 
 
 	/*********************************************************************************************************
@@ -129,11 +131,15 @@ public:
 	INT8U getError(void);                                               // Check for errors
 	INT8U errorCountRX(void);                                           // Get error count
 	INT8U errorCountTX(void);                                           // Get error count
+	INT8U clearRXnOVRFlags(void);                                       // Clear RXnOVR flags
+	INT8U setSleepWakeup(INT8U enable);                                 // Enable/disable wake up interrupt
 	INT8U enOneShotTX(void);                                            // Enable one-shot transmission
 	INT8U disOneShotTX(void);                                           // Disable one-shot transmission
 	INT8U abortTX(void);                                                // Abort queued transmission(s)
 	INT8U setGPO(INT8U data);                                           // Sets GPO
 	INT8U getGPI(void);                                                 // Reads GPI
+	INT32U getSpiCount(void);                                           // Get SPI transaction count
+	INT32U getSpiBytes(void);                                           // Get SPI byte count (MY_DEBUG_VERBOSE_CAN)
 };
 
 #endif
@@ -43,6 +43,7 @@
  *   Begin mt
  */
 #define TIMEOUTVALUE    800
+#define MODE_TIMEOUT_MS 50                                              /* longest frame at 5kbps       */
 #define MCP_SIDH        0
 #define MCP_SIDL        1
 #define MCP_EID8        2
@@ -66,6 +66,30 @@ bool transportHALSanityCheck(void)
 	return result;
 }
 
+uint16_t transportHALGetDuplicateCount(void)
+{
+	uint16_t result = transportGetDuplicateCount();
+	return result;
+}
+
+uint8_t transportHALGetStatistics(const char selector, void *data)
+{
+	uint8_t result = transportGetStatistics(selector, data);
+	TRANSPORT_HAL_DEBUG(PSTR("THA:STA:SEL=%c,LEN=%" PRIu8 "\n"), selector, result);
+	return result;
+}
+
+bool transportHALInterruptPending(void)
+{
+	return transportInterruptPending();
+}
+
+uint8_t transportHALGetBusLoad(void)
+{
+	uint8_t result = transportGetBusLoad();
+	return result;
+}
+
 bool transportHALReceive(MyMessage *inMsg, uint8_t *msgLength)
 {
 	// set pointer to first byte of data structure
@@ -77,33 +101,27 @@ bool transportHALReceive(MyMessage *inMsg, uint8_t *msgLength)
 #endif
 
 	// Reject messages with incorrect protocol version
-	MyMessage tmp = *inMsg;
-	if (!tmp.isProtocolVersionValid()) {
+	if (!inMsg->isProtocolVersionValid()) {
 		setIndication(INDICATION_ERR_VERSION);
 		TRANSPORT_HAL_DEBUG(PSTR("!THA:RCV:PVER=%" PRIu8 "\n"),
-		                    tmp.getVersion());	// protocol version mismatch
+		                    inMsg->getVersion());	// protocol version mismatch
 		return false;
 	}
-	*msgLength = tmp.getLength();
+	*msgLength = inMsg->getLength();
 
 	// Reject payloads with incorrect length
-	const uint8_t expectedMessageLength = tmp.getExpectedMessageSize();	
+	const uint8_t expectedMessageLength = inMsg->getExpectedMessageSize();
 	if (payloadLength != expectedMessageLength) {
-		setIndication(INDICATION_ERR_LENGTH);
-		TRANSPORT_HAL_DEBUG(PSTR("!THA:RCV:LEN=%" PRIu8 ",EXP=%" PRIu8 "\n"), payloadLength,
-		                    expectedMessageLength); // invalid payload length
-	uint8_t noOfFrames = expectedMessageLength / 8;
-	if (expectedMessageLength % 8 != 0) {
-		noOfFrames++;
-	}	
-	    if (payloadLength == noOfFrames*8){
-			payloadLength = expectedMessageLength;
-			TRANSPORT_HAL_DEBUG(PSTR("Fix PL Len"));
-		}
-		else {
+		// older CAN nodes pad the last frame to 8 bytes
+		const uint8_t paddedLength = (expectedMessageLength + 7) & ~0x07;
+		if (payloadLength != paddedLength) {
+			setIndication(INDICATION_ERR_LENGTH);
+			TRANSPORT_HAL_DEBUG(PSTR("!THA:RCV:LEN=%" PRIu8 ",EXP=%" PRIu8 "\n"), payloadLength,
+			                    expectedMessageLength); // invalid payload length
 			return false;
-		} 		
-		 
+		}
+		payloadLength = expectedMessageLength;
+		TRANSPORT_HAL_DEBUG(PSTR("THA:RCV:PAD\n"));
 	}
 
 	TRANSPORT_HAL_DEBUG(PSTR("THA:RCV:MSG LEN=%" PRIu8 "\n"), payloadLength);
@@ -131,7 +149,9 @@ bool transportHALSend(const uint8_t nextRecipient, const MyMessage *outMsg, cons
 	const uint8_t finalLength = len;
 
 
+	PROFILE_START(PROFILE_TRANSPORT_SEND);
 	bool result = transportSend(nextRecipient, (void *)tx_data, finalLength, noACK);
+	PROFILE_END(PROFILE_TRANSPORT_SEND);
 	TRANSPORT_HAL_DEBUG(PSTR("THA:SND:MSG LEN=%" PRIu8 ",RES=%" PRIu8 "\n"), finalLength, result);
 	return result;
 }
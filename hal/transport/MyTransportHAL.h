@@ -26,11 +26,13 @@
  * | | THA | GAD   | ADDR=%%d										| Get trnasport address (ADDR)
  * | | THA | DATA  | AVAIL											| Message available
  * | | THA | SAN   | RES=%%d										| Transport sanity check, result (RES)
+ * | | THA | STA   | SEL=%%c,LEN=%%d						| Transport statistics block (SEL) copied, length (LEN)
  * | | THA | RCV   | MSG=%%s										| Receive message (MSG)
  * | | THA | RCV   | DECRYPT										| Decrypt received message
  * | | THA | RCV   | PLAIN=%%s									| Decrypted message (PLAIN)
  * |!| THA | RCV   | PVER=%%d										| Message protocol version (PVER) mismatch
  * |!| THA | RCV   | LEN=%%d,EXP=%%d						| Invalid message length (LEN), exptected length (EXP)
+ * | | THA | RCV   | PAD												| Padded last %CAN frame of older node accepted
  * | | THA | RCV   | MSG LEN=%%d								| Length of received message (LEN)
  * | | THA | SND   | MSG=%%s										| Send message (MSG)
  * | | THA | SND   | ENCRYPT										| Encrypt message to send (%AES)
@@ -112,11 +114,33 @@ bool transportHALSend(const uint8_t nextRecipient, const MyMessage *outMsg, cons
 */
 bool transportHALDataAvailable(void);
 /**
+* @brief Transport HW signals work (e.g. received frame), cheap check without bus access
+* @return true if interrupt line asserted
+*/
+bool transportHALInterruptPending(void);
+/**
 * @brief Sanity check for transport: is transport HW still responsive?
 * @return true if transport HW is ok
 */
 bool transportHALSanityCheck(void);
 /**
+* @brief Number of duplicated messages dropped by the transport before reassembly
+* @return duplicate counter
+*/
+uint16_t transportHALGetDuplicateCount(void);
+/**
+* @brief Copy transport statistics block
+* @param selector block to copy, 'S' transport statistics, 'A' reassembly statistics
+* @param data buffer, at least MAX_PAYLOAD_SIZE bytes
+* @return length of statistics block, 0 if not available
+*/
+uint8_t transportHALGetStatistics(const char selector, void *data);
+/**
+* @brief Estimated bus load
+* @return bus load in percent
+*/
+uint8_t transportHALGetBusLoad(void);
+/**
 * @brief Receive message from FIFO
 * @param inMsg
 * @param msgLength length of received message (header + payload)
@@ -0,0 +1,64 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/*
+ * Mode changes of the MCP2515 take effect when CANSTAT reports them, e.g. after the frame on the bus.
+ * A controller recovery succeeds once both mode changes are confirmed within MODE_TIMEOUT_MS and
+ * fails if the controller does not enter a mode in time.
+ */
+
+#define MY_CAN
+#define MY_NODE_ID (5u)
+#define MY_PARENT_NODE_ID (1u)	// GATEWAY_ADDRESS
+#include <MySensorsLightCan.h>
+#include "HostShim.h"
+
+#define MODE_DELAY_US (2000ul)	// one frame at 50kbps
+
+static void _fail(const char *what)
+{
+	printf("FAIL %s\n", what);
+	exit(1);
+}
+
+void preHwInit(void)
+{
+	hostCanAttach(CAN_CS, CAN_INT, 50000ul);
+}
+
+void setup(void)
+{
+	hostCanSetModeDelay(MODE_DELAY_US);
+	const uint32_t changes = hostCanStats().modeChanges;
+	if (!_recoverController() || hostCanStats().modeChanges != changes + 2) {
+		_fail("delayed mode change not confirmed");
+	}
+	hostCanSetModeDelay((MODE_TIMEOUT_MS + 10ul) * 1000ul);
+	if (_recoverController()) {
+		_fail("recovery reported without a mode change");
+	}
+	printf("recovery: confirmed after %lums, failed after %ums without mode change\n",
+	       MODE_DELAY_US / 1000ul, MODE_TIMEOUT_MS);
+	printf("PASS\n");
+	exit(0);
+}
+
+void loop(void)
+{
+}
@@ -0,0 +1,176 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/*
+ * Network discovery under full bus load. The gateway broadcasts I_DISCOVER_REQUEST, then sends
+ * two frame C_SET messages back to back to the node for STRESS_MESSAGES. The node answers the
+ * discovery after its random delay (up to 1023ms) while it keeps receiving, no frame may be lost
+ * in the MCP2515 (RX0OVR / RX1OVR) and every message has to reach receive().
+ *
+ * A final self check blocks the node for STRESS_BLOCK_MS under the same load, the overflows have to
+ * show up in the emulator and in the transport statistics.
+ */
+
+#define MY_CAN
+#define MY_NODE_ID (5u)
+#define MY_PARENT_NODE_ID (1u)	// GATEWAY_ADDRESS
+#include <MySensorsLightCan.h>
+#include "HostShim.h"
+
+#define STRESS_MESSAGES (240u)		// ~1.2s of bus time at 50kbps
+#define STRESS_BLOCK_MS (100u)
+#define STRESS_SETTLE_US (20000ul)	// last frame processed
+#define STRESS_TIMEOUT_MS (10000ul)
+
+typedef enum {
+	STRESS_WAIT_READY,
+	STRESS_DISCOVERY,
+	STRESS_BLOCKED,
+	STRESS_DONE
+} stressPhase_t;
+
+static stressPhase_t _phase = STRESS_WAIT_READY;
+static uint32_t _received = 0;
+static uint8_t _messageId = 0;
+static uint64_t _loadEndUs = 0;
+
+static void _fail(const char *what)
+{
+	printf("FAIL %s\n", what);
+	exit(1);
+}
+
+// gateway sends a message to the node, frames as transportSend() builds them
+static void _injectMessage(MyMessage &message)
+{
+	const uint8_t *data = &message.sender;
+	const uint8_t length = message.getExpectedMessageSize();
+	const uint8_t frames = (length + 7) / 8;
+	_messageId = (_messageId + 1) & 0x07;
+	for (uint8_t part = 0; part < frames; part++) {
+		hostCanFrame_t frame;
+		frame.id = CAN_ID_BUILD(_messageId, frames, part, message.getDestination(), GATEWAY_ADDRESS);
+		frame.len = length - part * 8 > 8 ? 8 : length - part * 8;
+		for (uint8_t i = 0; i < frame.len; i++) {
+			frame.data[i] = data[part * 8 + i];
+		}
+		hostCanInject(hostCanBusFree() + hostCanFrameUs(frame.len), frame);
+	}
+}
+
+static void _injectLoad(const uint32_t messages)
+{
+	MyMessage message(1, V_TEMP);
+	(void)message.setSender(GATEWAY_ADDRESS).setDestination(MY_NODE_ID).setCommand(C_SET);
+	for (uint32_t i = 0; i < messages; i++) {
+		// values differ, nothing is dropped as duplicate
+		_injectMessage(message.set(20.0f + i * 0.1f, 1));
+	}
+}
+
+// discovery responses sent by the node
+static uint8_t _discoverResponses(void)
+{
+	uint8_t responses = 0;
+	hostCanFrame_t frame;
+	while (hostCanReceive(frame)) {
+		MyMessage message;
+		if (CAN_ID_TOTAL(frame.id) != 1 || CAN_ID_TO(frame.id) != GATEWAY_ADDRESS) {
+			continue;
+		}
+		(void)memcpy(&message.sender, frame.data, frame.len);
+		if (message.getCommand() == C_INTERNAL && message.getType() == I_DISCOVER_RESPONSE) {
+			responses++;
+		}
+	}
+	return responses;
+}
+
+void preHwInit(void)
+{
+	hostCanAttach(CAN_CS, CAN_INT, 50000ul);
+}
+
+void receive(const MyMessage &message)
+{
+	if (message.getCommand() == C_SET && message.getSender() == GATEWAY_ADDRESS) {
+		_received++;
+	}
+}
+
+void loop(void)
+{
+	canStats_t stats;
+	(void)transportHALGetStatistics('C', &stats);
+	if (millis() > STRESS_TIMEOUT_MS) {
+		_fail("timeout");
+	}
+	switch (_phase) {
+	case STRESS_WAIT_READY:
+		if (isTransportReady()) {
+			(void)_discoverResponses();
+			MyMessage request;
+			(void)build(request, BROADCAST_ADDRESS, NODE_SENSOR_ID, C_INTERNAL, I_DISCOVER_REQUEST);
+			(void)request.setSender(GATEWAY_ADDRESS).set((uint8_t)0);
+			_injectMessage(request);
+			_injectLoad(STRESS_MESSAGES);
+			_loadEndUs = hostCanBusFree() + STRESS_SETTLE_US;
+			_phase = STRESS_DISCOVERY;
+		}
+		break;
+	case STRESS_DISCOVERY:
+		if (hostMicros() < _loadEndUs || deferredPending()) {
+			break;
+		}
+		printf("discovery: %" PRIu32 " of %u messages received, %" PRIu32 " overflows, %" PRIu16
+		       " counted by the transport\n", _received, STRESS_MESSAGES, hostCanStats().overflows,
+		       stats.rxOverflows);
+		if (hostCanStats().overflows || stats.rxOverflows) {
+			_fail("receive buffer overflow during discovery");
+		}
+		if (_received != STRESS_MESSAGES) {
+			_fail("messages lost during discovery");
+		}
+		if (_discoverResponses() != 1) {
+			_fail("expected one discovery response");
+		}
+		_injectLoad(10);
+		_loadEndUs = hostCanBusFree() + STRESS_SETTLE_US;
+		delay(STRESS_BLOCK_MS);
+		_phase = STRESS_BLOCKED;
+		break;
+	case STRESS_BLOCKED:
+		if (hostMicros() < _loadEndUs) {
+			break;
+		}
+		// next sanity check of the transport counts the overflow
+		(void)transportHALSanityCheck();
+		(void)transportHALGetStatistics('C', &stats);
+		printf("blocked %ums: %" PRIu32 " overflows, %" PRIu16 " counted by the transport\n",
+		       STRESS_BLOCK_MS, hostCanStats().overflows, stats.rxOverflows);
+		if (!hostCanStats().overflows || !stats.rxOverflows) {
+			_fail("overflow not detected while blocked");
+		}
+		_phase = STRESS_DONE;
+		break;
+	case STRESS_DONE:
+		printf("PASS\n");
+		exit(0);
+	}
+}
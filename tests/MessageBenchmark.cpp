@@ -0,0 +1,266 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/*
+ * Per message CPU work of a serial %CAN gateway: MyMessage accessors, serial protocol, binary
+ * protocol and the %CAN receive path down to the emulated MCP2515.
+ *
+ * Reports ns/op (host time, best of BENCH_REPEATS) and bytes-copied/op (memcpy() / strncpy() of the
+ * library, struct assignments are not counted). With BENCH_BASELINE set, results are checked against
+ * the baseline file: bytes-copied/op has to match, ns/op above BENCH_SLOWDOWN x baseline is reported
+ * and fails the run with BENCH_STRICT=1. BENCH_UPDATE=1 rewrites the baseline instead.
+ */
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#define MY_CAN
+#define MY_GATEWAY_SERIAL
+// acceptance filters are set up from MY_NODE_ID, before the transport assigns the gateway address
+#define MY_NODE_ID (1u)	// GATEWAY_ADDRESS
+#include <MySensorsLightCan.h>
+#include "HostShim.h"
+
+#define BENCH_REPEATS (5u)
+#define BENCH_SLOWDOWN (1.5)
+#define BENCH_NODE (5u)
+
+typedef struct {
+	std::string name;
+	double nsPerOp;
+	double bytesPerOp;
+} benchResult_t;
+
+static std::vector<benchResult_t> _results;
+static volatile uint32_t _sink;
+static uint32_t _failures = 0;	// operations not taking the expected path
+
+template <typename T> static void _bench(const char *name, const uint32_t iterations, T operation)
+{
+	double best = 0;
+	uint32_t bytes = 0;
+	for (uint8_t repeat = 0; repeat < BENCH_REPEATS; repeat++) {
+		const uint32_t bytesStart = hostBytesCopied();
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < iterations; i++) {
+			operation(i);
+		}
+		const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() -
+		                  start).count();
+		if (!repeat || ns < best) {
+			best = ns;
+		}
+		bytes = hostBytesCopied() - bytesStart;
+	}
+	benchResult_t result;
+	result.name = name;
+	result.nsPerOp = best / iterations;
+	result.bytesPerOp = (double)bytes / iterations;
+	_results.push_back(result);
+}
+
+// node BENCH_NODE sends a message to the gateway, frames as transportSend() builds them
+static void _injectMessage(const MyMessage &message, const uint8_t messageId)
+{
+	const uint8_t *data = &message.sender;
+	const uint8_t length = message.getExpectedMessageSize();
+	const uint8_t frames = (length + 7) / 8;
+	for (uint8_t part = 0; part < frames; part++) {
+		hostCanFrame_t frame;
+		frame.id = CAN_ID_BUILD(messageId, frames, part, GATEWAY_ADDRESS, BENCH_NODE);
+		frame.len = length - part * 8 > 8 ? 8 : length - part * 8;
+		for (uint8_t i = 0; i < frame.len; i++) {
+			frame.data[i] = data[part * 8 + i];
+		}
+		hostCanInject(hostCanBusFree() + hostCanFrameUs(frame.len), frame);
+	}
+}
+
+static void _runBenchmarks(void)
+{
+	MyMessage message(1, V_TEMP);
+	char buffer[MY_GATEWAY_MAX_SEND_LENGTH];
+
+	_bench("msg_set_float", 1000000ul, [&](const uint32_t i) {
+		_sink += message.set(21.5f + (i & 0x0F), 2).data[0];
+	});
+	_bench("msg_set_string", 1000000ul, [&](const uint32_t i) {
+		(void)i;
+		_sink += message.set("kitchen ceiling").data[0];
+	});
+	(void)message.set(21.53f, 2);
+	_bench("msg_get_float", 1000000ul, [&](const uint32_t i) {
+		(void)i;
+		_sink += (uint32_t)message.getFloat();
+	});
+	(void)message.set((uint32_t)123456ul);
+	_bench("msg_get_long", 1000000ul, [&](const uint32_t i) {
+		(void)i;
+		_sink += message.getULong();
+	});
+	(void)message.set(21.53f, 2);
+	_bench("msg_get_string_float", 200000ul, [&](const uint32_t i) {
+		(void)i;
+		_sink += (uint8_t)message.getString(buffer)[0];
+	});
+	(void)message.set("kitchen ceiling");
+	_bench("msg_get_string", 1000000ul, [&](const uint32_t i) {
+		(void)i;
+		_sink += (uint8_t)message.getString(buffer)[0];
+	});
+
+	char line[] = "12;6;1;0;0;36.5\n";
+	_bench("protocol_serial2message", 500000ul, [&](const uint32_t i) {
+		(void)i;
+		_failures += !protocolSerial2MyMessage(message, line);
+	});
+	_bench("protocol_message2serial", 500000ul, [&](const uint32_t i) {
+		(void)i;
+		_sink += protocolFormatSerial(message, buffer);
+	});
+	uint8_t frame[PROTOCOL_BINARY_MAX_FRAME];
+	_bench("protocol_message2binary", 500000ul, [&](const uint32_t i) {
+		(void)i;
+		_sink += protocolMyMessage2Binary(message, frame);
+	});
+	// without the delimiter(s)
+	const uint8_t frameStart = frame[0] ? 0 : 1;
+	const uint8_t frameLength = protocolMyMessage2Binary(message, frame) - frameStart - 1;
+	_bench("protocol_binary2message", 500000ul, [&](const uint32_t i) {
+		(void)i;
+		_failures += !protocolBinary2MyMessage(message, frame + frameStart, frameLength);
+	});
+
+	_bench("can_build_header", 1000000ul, [&](const uint32_t i) {
+		_sink += _buildHeader(i & 0x07, 2, i & 0x01, GATEWAY_ADDRESS, BENCH_NODE);
+	});
+
+	// single frame message, decoded by transportDataAvailable() incl. SPI to the emulated controller
+	MyMessage reading(1, V_TEMP);
+	(void)reading.setSender(BENCH_NODE).setDestination(GATEWAY_ADDRESS).setCommand(C_SET).set((uint8_t)0);
+	uint8_t length;
+	_bench("can_receive_frame", 20000ul, [&](const uint32_t i) {
+		// message id and payload change, nothing is dropped as duplicate
+		reading.data[0] = (uint8_t)(i >> 3);
+		_injectMessage(reading, i & 0x07);
+		hostAdvance((uint32_t)(hostCanBusFree() - hostMicros()));
+		_failures += !transportDataAvailable();
+		_failures += !transportHALReceive(&message, &length);
+	});
+
+	// validation of a reassembled message
+	_bench("hal_receive", 1000000ul, [&](const uint32_t i) {
+		(void)i;
+		packets[0].len = reading.getExpectedMessageSize();
+		packets[0].ready = true;
+		_failures += !transportHALReceive(&message, &length);
+	});
+}
+
+static bool _checkBaseline(const char *path)
+{
+	FILE *file = fopen(path, "r");
+	if (!file) {
+		printf("no baseline %s, run make benchmark-baseline\n", path);
+		return false;
+	}
+	std::map<std::string, benchResult_t> baseline;
+	char lineBuffer[128];
+	while (fgets(lineBuffer, sizeof(lineBuffer), file)) {
+		char name[64];
+		benchResult_t entry;
+		if (lineBuffer[0] != '#' && sscanf(lineBuffer, "%63s %lf %lf", name, &entry.bytesPerOp,
+		                                   &entry.nsPerOp) == 3) {
+			baseline[name] = entry;
+		}
+	}
+	fclose(file);
+	const bool strict = getenv("BENCH_STRICT") != NULL;
+	bool ok = true;
+	for (size_t i = 0; i < _results.size(); i++) {
+		const benchResult_t &result = _results[i];
+		if (!baseline.count(result.name)) {
+			printf("FAIL %s: not in baseline\n", result.name.c_str());
+			ok = false;
+			continue;
+		}
+		const benchResult_t &expected = baseline[result.name];
+		if (result.bytesPerOp > expected.bytesPerOp + 0.05 || result.bytesPerOp < expected.bytesPerOp - 0.05) {
+			printf("FAIL %s: %.1f bytes-copied/op, baseline %.1f\n", result.name.c_str(), result.bytesPerOp,
+			       expected.bytesPerOp);
+			ok = false;
+		}
+		if (result.nsPerOp > expected.nsPerOp * BENCH_SLOWDOWN) {
+			printf("%s %s: %.1f ns/op, baseline %.1f\n", strict ? "FAIL" : "SLOW", result.name.c_str(),
+			       result.nsPerOp, expected.nsPerOp);
+			ok = ok && !strict;
+		}
+	}
+	return ok;
+}
+
+static void _writeBaseline(const char *path)
+{
+	FILE *file = fopen(path, "w");
+	if (!file) {
+		printf("cannot write %s\n", path);
+		exit(1);
+	}
+	fprintf(file, "# name bytes-copied/op ns/op, written by make benchmark-baseline\n");
+	for (size_t i = 0; i < _results.size(); i++) {
+		fprintf(file, "%s %.1f %.1f\n", _results[i].name.c_str(), _results[i].bytesPerOp,
+		        _results[i].nsPerOp);
+	}
+	fclose(file);
+}
+
+void preHwInit(void)
+{
+	hostCanAttach(CAN_CS, CAN_INT, 50000ul);
+}
+
+void setup(void)
+{
+	_runBenchmarks();
+	if (_failures) {
+		printf("FAIL %" PRIu32 " operations failed\n", _failures);
+		exit(1);
+	}
+	printf("%-26s %12s %16s\n", "benchmark", "ns/op", "bytes-copied/op");
+	for (size_t i = 0; i < _results.size(); i++) {
+		printf("%-26s %12.1f %16.1f\n", _results[i].name.c_str(), _results[i].nsPerOp,
+		       _results[i].bytesPerOp);
+	}
+	const char *baseline = getenv("BENCH_BASELINE");
+	if (!baseline) {
+		exit(0);
+	}
+	if (getenv("BENCH_UPDATE")) {
+		_writeBaseline(baseline);
+		printf("baseline %s written\n", baseline);
+		exit(0);
+	}
+	exit(_checkBaseline(baseline) ? 0 : 1);
+}
+
+void loop(void)
+{
+}
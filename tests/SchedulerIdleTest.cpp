@@ -0,0 +1,139 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/*
+ * A node leaving its work to the scheduler idles in schedulerRun(). At 500kbps both receive buffers
+ * fill within one timer0 tick, CAN_INT has to end the idle period or frames are lost in the MCP2515
+ * (RX0OVR / RX1OVR).
+ */
+
+#define MY_CAN
+#define MY_NODE_ID (5u)
+#define MY_PARENT_NODE_ID (1u)	// GATEWAY_ADDRESS
+#define CAN_INT (2u)	// INT0
+#define MY_SCHEDULER_TASKS (2u)
+#include <MySensorsLightCan.h>
+#include "HostShim.h"
+
+#define IDLE_MESSAGES (400u)		// ~0.2s of bus time at 500kbps
+#define IDLE_SETTLE_US (20000ul)	// last frame processed
+#define IDLE_TIMEOUT_MS (10000ul)
+
+static bool _loaded = false;
+static uint32_t _received = 0;
+static uint32_t _ticks = 0;
+static uint8_t _messageId = 0;
+static uint64_t _loadEndUs = 0;
+
+static void _fail(const char *what)
+{
+	printf("FAIL %s\n", what);
+	exit(1);
+}
+
+// gateway sends a message to the node, frames as transportSend() builds them
+static void _injectMessage(MyMessage &message)
+{
+	const uint8_t *data = &message.sender;
+	const uint8_t length = message.getExpectedMessageSize();
+	const uint8_t frames = (length + 7) / 8;
+	_messageId = (_messageId + 1) & 0x07;
+	for (uint8_t part = 0; part < frames; part++) {
+		hostCanFrame_t frame;
+		frame.id = CAN_ID_BUILD(_messageId, frames, part, message.getDestination(), GATEWAY_ADDRESS);
+		frame.len = length - part * 8 > 8 ? 8 : length - part * 8;
+		for (uint8_t i = 0; i < frame.len; i++) {
+			frame.data[i] = data[part * 8 + i];
+		}
+		hostCanInject(hostCanBusFree() + hostCanFrameUs(frame.len), frame);
+	}
+}
+
+static void _tick(void)
+{
+	_ticks++;
+}
+
+void preHwInit(void)
+{
+	hostCanAttach(CAN_CS, CAN_INT, 500000ul);
+}
+
+void setup(void)
+{
+	if (schedulerAdd(_tick, 10, 10) == SCHEDULER_TASK_NONE) {
+		_fail("no task slot");
+	}
+	// the handle of a cancelled task must not cancel the next task in its slot
+	const schedulerHandle_t stale = schedulerAdd(_tick, 10, 0);
+	if (!schedulerCancel(stale) || schedulerCancel(stale)) {
+		_fail("cancel");
+	}
+	const schedulerHandle_t reused = schedulerAdd(_tick, 10, 0);
+	if ((uint8_t)reused != (uint8_t)stale || schedulerCancel(stale) || !schedulerCancel(reused)) {
+		_fail("stale handle cancelled a reused slot");
+	}
+}
+
+void receive(const MyMessage &message)
+{
+	if (message.getCommand() == C_SET && message.getSender() == GATEWAY_ADDRESS) {
+		_received++;
+	}
+}
+
+void loop(void)
+{
+	schedulerRun();
+	if (millis() > IDLE_TIMEOUT_MS) {
+		_fail("timeout");
+	}
+	if (!_loaded) {
+		if (isTransportReady()) {
+			MyMessage message(1, V_TEMP);
+			(void)message.setSender(GATEWAY_ADDRESS).setDestination(MY_NODE_ID).setCommand(C_SET);
+			for (uint32_t i = 0; i < IDLE_MESSAGES; i++) {
+				// values differ, nothing is dropped as duplicate
+				_injectMessage(message.set(20.0f + i * 0.1f, 1));
+			}
+			_loadEndUs = hostCanBusFree() + IDLE_SETTLE_US;
+			_loaded = true;
+		}
+		return;
+	}
+	if (hostMicros() < _loadEndUs) {
+		return;
+	}
+	canStats_t stats;
+	(void)transportHALGetStatistics('C', &stats);
+	printf("idle: %" PRIu32 " of %u messages received, %" PRIu32 " overflows, %" PRIu16
+	       " counted by the transport, %" PRIu32 " task runs\n", _received, IDLE_MESSAGES,
+	       hostCanStats().overflows, stats.rxOverflows, _ticks);
+	if (hostCanStats().overflows || stats.rxOverflows) {
+		_fail("receive buffer overflow while idling");
+	}
+	if (_received != IDLE_MESSAGES) {
+		_fail("messages lost while idling");
+	}
+	if (!_ticks) {
+		_fail("task did not run");
+	}
+	printf("PASS\n");
+	exit(0);
+}
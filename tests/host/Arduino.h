@@ -0,0 +1,245 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/**
+ * @file Arduino.h
+ *
+ * Host shim of the Arduino core for the AVR hardware layer, see HostShim.h. The pin macros of
+ * digitalWriteFast.h fall back to digitalWrite() / digitalRead() because no MCU is defined, which
+ * routes the MCP2515 chip select and interrupt pins to the emulator.
+ */
+
+#ifndef HostArduino_h
+#define HostArduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <inttypes.h>
+#include <math.h>
+
+// copies done by the library are counted for the benchmarks, see hostBytesCopied()
+extern uint32_t _hostBytesCopied;
+static inline void *_hostMemcpy(void *dest, const void *src, size_t n)
+{
+	_hostBytesCopied += n;
+	return memmove(dest, src, n);
+}
+static inline char *_hostStrncpy(char *dest, const char *src, size_t n)
+{
+	_hostBytesCopied += n;
+	return strncpy(dest, src, n);
+}
+#define memcpy(__dest, __src, __n) _hostMemcpy((__dest), (__src), (__n))
+#define strncpy(__dest, __src, __n) _hostStrncpy((__dest), (__src), (__n))
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define F_CPU 16000000UL
+#define __AVR__ 1
+#define ARDUINO 10813
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define PGM_P const char *
+#define pgm_read_byte(a) (*(const uint8_t *)(a))
+#define pgm_read_word(a) (*(const uint16_t *)(a))
+#define pgm_read_dword(a) (*(const uint32_t *)(a))
+#define pgm_read_ptr(a) (*(void * const *)(a))
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define memcpy_P memcpy
+#define vsnprintf_P vsnprintf
+#define snprintf_P snprintf
+#define sprintf_P sprintf
+#define printf_P printf
+class __FlashStringHelper;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define NOT_AN_INTERRUPT -1
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define _BV(b) (1 << (b))
+#define bit_is_set(sfr, bit) ((sfr) & _BV(bit))
+#define bit_is_clear(sfr, bit) (!((sfr) & _BV(bit)))
+#define word(a) ((uint16_t)(a))
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void pinMode(uint8_t pin, uint8_t mode);
+int analogRead(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+void init(void);
+void yield(void);
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+void interrupts(void);
+void noInterrupts(void);
+char *itoa(int value, char *buffer, int radix);
+char *ltoa(long value, char *buffer, int radix);
+char *utoa(unsigned int value, char *buffer, int radix);
+char *ultoa(unsigned long value, char *buffer, int radix);
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer);
+void serialEventRun(void) __attribute__((weak));
+
+// registers touched by the AVR hardware layer, plain variables on the host
+extern volatile uint8_t PORTB, PORTC, PORTD, DDRB, DDRC, DDRD, PINB, PINC, PIND;
+extern volatile uint8_t ADMUX, ADCSRA, TCCR1A, TCCR1B, TCCR1C, TIFR1, WDTCSR, EIFR, OSCCAL, SREG, MCUSR,
+       EICRA, EIMSK;
+extern volatile uint16_t ADCW, TCNT1, ADC;
+extern volatile uint8_t UCSR0A, UCSR0B, UCSR0C, UBRR0H, UBRR0L, UDR0;
+extern volatile uint16_t UBRR0;
+#define ADEN 7
+#define ADSC 6
+#define MUX0 0
+#define MUX1 1
+#define MUX2 2
+#define MUX3 3
+#define MUX4 4
+#define MUX5 5
+#define REFS0 6
+#define REFS1 7
+#define CS10 0
+#define CS12 2
+#define WDCE 4
+#define WDE 3
+#define WDIE 6
+#define WDIF 7
+#define INT0 0
+#define INT1 1
+#define TOV1 0
+#define RXC0 7
+#define TXC0 6
+#define UDRE0 5
+#define FE0 4
+#define DOR0 3
+#define UPE0 2
+#define U2X0 1
+#define RXCIE0 7
+#define TXCIE0 6
+#define UDRIE0 5
+#define RXEN0 4
+#define TXEN0 3
+#define UCSZ01 2
+#define UCSZ00 1
+#define MPCM0 0
+#define SREG_I 7
+#define SIGNATURE_0 0x1e
+#define SIGNATURE_1 0x95
+#define SIGNATURE_2 0x0f
+#define ISR(v) extern "C" void v(void)
+#define USART_RX_vect __vector_18
+#define USART_UDRE_vect __vector_19
+
+class Print
+{
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t data) = 0;
+	virtual size_t write(const uint8_t *buffer, size_t size)
+	{
+		size_t n = 0;
+		while (size--) {
+			n += write(*buffer++);
+		}
+		return n;
+	}
+	size_t write(const char *str)
+	{
+		return write(reinterpret_cast<const uint8_t *>(str), strlen(str));
+	}
+	size_t write(const char *buffer, size_t size)
+	{
+		return write(reinterpret_cast<const uint8_t *>(buffer), size);
+	}
+	virtual int availableForWrite()
+	{
+		return 0;
+	}
+	virtual void flush() {}
+	size_t print(const char *str);
+	size_t print(char c);
+	size_t print(int value, int base = 10);
+	size_t print(unsigned int value, int base = 10);
+	size_t print(long value, int base = 10);
+	size_t print(unsigned long value, int base = 10);
+	size_t print(unsigned char value, int base = 10);
+	size_t print(double value, int digits = 2);
+	size_t print(const __FlashStringHelper *str);
+	size_t println(const char *str);
+	size_t println(void);
+	size_t println(int value, int base = 10);
+};
+
+class Stream : public Print
+{
+public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+};
+
+// output is collected, input is fed by the test, see hostSerialInput()
+class HardwareSerial : public Stream
+{
+public:
+	void begin(unsigned long baud);
+	void end();
+	int available();
+	int read();
+	int peek();
+	int availableForWrite();
+	size_t write(uint8_t data);
+	using Print::write;
+	operator bool()
+	{
+		return true;
+	}
+};
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,375 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include <string.h>
+#include "HostMCP2515.h"
+
+// SPI instructions
+#define CMD_NONE (0x00)
+#define CMD_WRITE (0x02)
+#define CMD_READ (0x03)
+#define CMD_BITMOD (0x05)
+#define CMD_READ_STATUS (0xA0)
+#define CMD_RESET (0xC0)
+
+// registers
+#define REG_CANSTAT (0x0E)
+#define REG_CANCTRL (0x0F)
+#define REG_TEC (0x1C)
+#define REG_REC (0x1D)
+#define REG_RXM0 (0x20)
+#define REG_RXM1 (0x24)
+#define REG_CANINTE (0x2B)
+#define REG_CANINTF (0x2C)
+#define REG_EFLG (0x2D)
+#define REG_TXB0CTRL (0x30)
+#define REG_RXB0CTRL (0x60)
+#define REG_RXB1CTRL (0x70)
+
+// bits
+#define OPMOD_MASK (0xE0)
+#define OPMOD_NORMAL (0x00)
+#define OPMOD_SLEEP (0x20)
+#define OPMOD_LISTEN (0x60)
+#define OPMOD_CONFIG (0x80)
+#define TXREQ (0x08)
+#define RXM_ANY (0x60)
+#define BUKT (0x04)
+#define EXIDE (0x08)
+#define RX0IF (0x01)
+#define RX1IF (0x02)
+#define TX0IF (0x04)
+#define WAKIF (0x40)
+#define RX0OVR (0x40)
+#define RX1OVR (0x80)
+
+static uint32_t _extendedId(const uint8_t *regs)
+{
+	const uint32_t sid = ((uint32_t)regs[0] << 3) | (regs[1] >> 5);
+	return (sid << 18) | ((uint32_t)(regs[1] & 0x03) << 16) | ((uint32_t)regs[2] << 8) | regs[3];
+}
+
+HostMCP2515::HostMCP2515()
+{
+	_bitrate = 50000ul;
+	_modeDelayUs = 0;
+	(void)memset(&_stats, 0, sizeof(_stats));
+	_unknownCommands = 0;
+	reset();
+}
+
+void HostMCP2515::reset(void)
+{
+	(void)memset(_regs, 0, sizeof(_regs));
+	_regs[REG_CANSTAT] = OPMOD_CONFIG;
+	_regs[REG_CANCTRL] = OPMOD_CONFIG | 0x07;
+	_command = CMD_NONE;
+	_position = 0;
+	_modeDueUs = HOST_NO_EVENT;
+	for (uint8_t i = 0; i < 3; i++) {
+		_txDueUs[i] = HOST_NO_EVENT;
+	}
+}
+
+void HostMCP2515::setBitrate(const uint32_t bitrate)
+{
+	_bitrate = bitrate;
+}
+
+void HostMCP2515::setModeDelay(const uint32_t us)
+{
+	_modeDelayUs = us;
+}
+
+uint32_t HostMCP2515::frameUs(const uint8_t len) const
+{
+	// same worst case as the transport: stuffed SOF..CRC, unstuffed trailer and interframe space
+	const uint32_t stuffedBits = 54 + 8 * len;
+	const uint32_t bits = stuffedBits + (stuffedBits - 1) / 4 + 13;
+	return bits * 1000000ul / _bitrate;
+}
+
+void HostMCP2515::select(void)
+{
+	_command = CMD_NONE;
+	_position = 0;
+}
+
+uint8_t HostMCP2515::_opmod(void) const
+{
+	return _regs[REG_CANSTAT] & OPMOD_MASK;
+}
+
+uint8_t HostMCP2515::_read(const uint8_t address) const
+{
+	// CANSTAT and CANCTRL are mapped into every row
+	if ((address & 0x0F) >= REG_CANSTAT) {
+		return _regs[address & 0x0F];
+	}
+	return _regs[address];
+}
+
+void HostMCP2515::_write(const uint8_t address, const uint8_t value)
+{
+	const uint8_t row = address & 0x0F;
+	if (row == REG_CANSTAT) {
+		return;
+	}
+	if (row == REG_CANCTRL) {
+		const uint8_t old = _regs[REG_CANCTRL];
+		_regs[REG_CANCTRL] = value;
+		if ((old ^ value) & OPMOD_MASK) {
+			_modeDueUs = hostMicros() + _modeDelayUs;
+			if (!_modeDelayUs) {
+				runEvents(hostMicros());
+			}
+		}
+		return;
+	}
+	if (address == REG_TEC || address == REG_REC) {
+		return;
+	}
+	if (address < REG_CANINTE && row < 0x0C && _opmod() != OPMOD_CONFIG) {
+		// filters, masks and bit timing
+		return;
+	}
+	if (address == REG_EFLG) {
+		// only the overflow flags can be cleared
+		_regs[REG_EFLG] = (_regs[REG_EFLG] & ~(RX0OVR | RX1OVR)) | (value & (RX0OVR | RX1OVR));
+		return;
+	}
+	if (address == REG_RXB0CTRL) {
+		_regs[address] = (_regs[address] & ~(RXM_ANY | BUKT)) | (value & (RXM_ANY | BUKT));
+		return;
+	}
+	if (address == REG_RXB1CTRL) {
+		_regs[address] = (_regs[address] & ~RXM_ANY) | (value & RXM_ANY);
+		return;
+	}
+	if (address >= REG_TXB0CTRL && address < REG_RXB0CTRL && !(address & 0x0F)) {
+		const uint8_t buffer = (address - REG_TXB0CTRL) >> 4;
+		const bool request = !(_regs[address] & TXREQ) && (value & TXREQ);
+		_regs[address] = (_regs[address] & ~(TXREQ | 0x03)) | (value & (TXREQ | 0x03));
+		if (!(value & TXREQ)) {
+			_txDueUs[buffer] = HOST_NO_EVENT;
+		} else if (request && _opmod() == OPMOD_NORMAL) {
+			_startTransmit(buffer);
+		}
+		return;
+	}
+	_regs[address] = value;
+}
+
+uint8_t HostMCP2515::transfer(const uint8_t data)
+{
+	const uint8_t position = _position;
+	if (_position < 0xFF) {
+		_position++;
+	}
+	if (!position) {
+		_command = data;
+		if (data == CMD_RESET) {
+			reset();
+		} else if (data != CMD_READ && data != CMD_WRITE && data != CMD_BITMOD &&
+		           data != CMD_READ_STATUS) {
+			_unknownCommands++;
+		}
+		return 0xFF;
+	}
+	switch (_command) {
+	case CMD_READ:
+		if (position == 1) {
+			_address = data & 0x7F;
+			return 0xFF;
+		} else {
+			const uint8_t value = _read(_address);
+			_address = (_address + 1) & 0x7F;
+			return value;
+		}
+	case CMD_WRITE:
+		if (position == 1) {
+			_address = data & 0x7F;
+		} else {
+			_write(_address, data);
+			_address = (_address + 1) & 0x7F;
+		}
+		return 0xFF;
+	case CMD_BITMOD:
+		if (position == 1) {
+			_address = data & 0x7F;
+		} else if (position == 2) {
+			_mask = data;
+		} else if (position == 3) {
+			_write(_address, (_read(_address) & ~_mask) | (data & _mask));
+		}
+		return 0xFF;
+	case CMD_READ_STATUS: {
+		const uint8_t intf = _regs[REG_CANINTF];
+		uint8_t status = intf & (RX0IF | RX1IF);
+		for (uint8_t i = 0; i < 3; i++) {
+			status |= (_regs[REG_TXB0CTRL + (i << 4)] & TXREQ) ? (0x04 << (2 * i)) : 0;
+			status |= (intf & (TX0IF << i)) ? (0x08 << (2 * i)) : 0;
+		}
+		return status;
+	}
+	default:
+		return 0xFF;
+	}
+}
+
+void HostMCP2515::_startTransmit(const uint8_t buffer)
+{
+	const uint8_t dlc = _regs[REG_TXB0CTRL + (buffer << 4) + 5] & 0x0F;
+	_txDueUs[buffer] = hostMicros() + frameUs(dlc > 8 ? 8 : dlc);
+}
+
+uint64_t HostMCP2515::nextEvent(void) const
+{
+	uint64_t next = _modeDueUs;
+	for (uint8_t i = 0; i < 3; i++) {
+		if (_txDueUs[i] < next) {
+			next = _txDueUs[i];
+		}
+	}
+	return next;
+}
+
+void HostMCP2515::runEvents(const uint64_t nowUs)
+{
+	if (_modeDueUs <= nowUs) {
+		_modeDueUs = HOST_NO_EVENT;
+		const uint8_t requested = _regs[REG_CANCTRL] & OPMOD_MASK;
+		if (requested != _opmod()) {
+			_regs[REG_CANSTAT] = (_regs[REG_CANSTAT] & ~OPMOD_MASK) | requested;
+			_stats.modeChanges++;
+			for (uint8_t i = 0; i < 3; i++) {
+				if (requested == OPMOD_NORMAL && (_regs[REG_TXB0CTRL + (i << 4)] & TXREQ) &&
+				        _txDueUs[i] == HOST_NO_EVENT) {
+					_startTransmit(i);
+				} else if (requested != OPMOD_NORMAL) {
+					_txDueUs[i] = HOST_NO_EVENT;
+				}
+			}
+		}
+	}
+	for (uint8_t i = 0; i < 3; i++) {
+		if (_txDueUs[i] > nowUs) {
+			continue;
+		}
+		_txDueUs[i] = HOST_NO_EVENT;
+		const uint8_t *regs = &_regs[REG_TXB0CTRL + (i << 4)];
+		hostCanFrame_t frame;
+		frame.id = 0x80000000ul | _extendedId(regs + 1);
+		frame.len = regs[5] & 0x0F;
+		frame.len = frame.len > 8 ? 8 : frame.len;
+		(void)memcpy(frame.data, regs + 6, 8);
+		_sent.push_back(frame);
+		_stats.sent++;
+		_regs[REG_TXB0CTRL + (i << 4)] &= ~TXREQ;
+		_regs[REG_CANINTF] |= TX0IF << i;
+	}
+}
+
+bool HostMCP2515::_accepts(const uint8_t firstFilter, const uint8_t filters, const uint8_t maskAddress,
+                           const uint32_t id) const
+{
+	const uint32_t mask = _extendedId(&_regs[maskAddress]);
+	for (uint8_t i = firstFilter; i < firstFilter + filters; i++) {
+		const uint8_t *filter = &_regs[(i < 3 ? 0x00 : 0x10) + 4 * (i % 3)];
+		if ((filter[1] & EXIDE) && !((_extendedId(filter) ^ id) & mask)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void HostMCP2515::_store(const uint8_t buffer, const hostCanFrame_t &frame)
+{
+	uint8_t *regs = &_regs[REG_RXB0CTRL + (buffer << 4)];
+	const uint32_t id = frame.id & 0x1FFFFFFFul;
+	regs[1] = (uint8_t)(id >> 21);
+	regs[2] = (uint8_t)(((id >> 13) & 0xE0) | EXIDE | ((id >> 16) & 0x03));
+	regs[3] = (uint8_t)(id >> 8);
+	regs[4] = (uint8_t)id;
+	regs[5] = frame.len;
+	(void)memcpy(regs + 6, frame.data, 8);
+	_regs[REG_CANINTF] |= RX0IF << buffer;
+	_stats.delivered++;
+}
+
+void HostMCP2515::receive(const hostCanFrame_t &frame)
+{
+	const uint8_t opmod = _opmod();
+	if (opmod == OPMOD_SLEEP && (_regs[REG_CANINTE] & WAKIF)) {
+		// the frame only wakes the controller
+		_regs[REG_CANINTF] |= WAKIF;
+		_regs[REG_CANSTAT] = (_regs[REG_CANSTAT] & ~OPMOD_MASK) | OPMOD_LISTEN;
+		_stats.modeChanges++;
+	}
+	if (opmod != OPMOD_NORMAL && opmod != OPMOD_LISTEN) {
+		_stats.filtered++;
+		return;
+	}
+	const uint32_t id = frame.id & 0x1FFFFFFFul;
+	const bool any0 = (_regs[REG_RXB0CTRL] & RXM_ANY) == RXM_ANY;
+	const bool any1 = (_regs[REG_RXB1CTRL] & RXM_ANY) == RXM_ANY;
+	uint8_t buffer;
+	if (any0 || _accepts(0, 2, REG_RXM0, id)) {
+		buffer = 0;
+		if ((_regs[REG_CANINTF] & RX0IF) && (_regs[REG_RXB0CTRL] & BUKT)) {
+			buffer = 1;
+		}
+	} else if (any1 || _accepts(2, 4, REG_RXM1, id)) {
+		buffer = 1;
+	} else {
+		_stats.filtered++;
+		return;
+	}
+	if (_regs[REG_CANINTF] & (RX0IF << buffer)) {
+		_regs[REG_EFLG] |= buffer ? RX1OVR : RX0OVR;
+		_stats.overflows++;
+		return;
+	}
+	_store(buffer, frame);
+}
+
+bool HostMCP2515::interruptAsserted(void) const
+{
+	return (_regs[REG_CANINTF] & _regs[REG_CANINTE]) != 0;
+}
+
+bool HostMCP2515::popSent(hostCanFrame_t &frame)
+{
+	if (_sent.empty()) {
+		return false;
+	}
+	frame = _sent.front();
+	_sent.pop_front();
+	return true;
+}
+
+const hostCanStats_t &HostMCP2515::stats(void) const
+{
+	return _stats;
+}
+
+uint32_t HostMCP2515::unknownCommands(void) const
+{
+	return _unknownCommands;
+}
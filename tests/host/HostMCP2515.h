@@ -0,0 +1,83 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/**
+ * @file HostMCP2515.h
+ *
+ * Register level MCP2515 behind the host SPI, used by HostShim.cpp only. Behaviour follows the
+ * datasheet (DS20001801) where the driver depends on it:
+ * - CANCTRL.REQOP is applied to CANSTAT.OPMOD after the configured mode delay
+ * - masks, filters and bit timing are writable in configuration mode only
+ * - frames are accepted by RXM / filters, RXB0 rolls over to RXB1 with BUKT, a frame finding its
+ *   buffer full sets RX0OVR / RX1OVR and is lost
+ * - TXREQ in normal mode sends the frame, TXREQ clears and TXnIF is set after its bus time
+ * - in sleep mode bus activity sets WAKIF and wakes the controller into listen only mode
+ * - INT is asserted while CANINTF & CANINTE
+ * Frames of the node do not delay frames of other nodes, there is no arbitration.
+ */
+
+#ifndef HostMCP2515_h
+#define HostMCP2515_h
+
+#include <stdint.h>
+#include <deque>
+#include "HostShim.h"
+
+#define HOST_NO_EVENT (~(uint64_t)0)	//!< no pending event
+
+class HostMCP2515
+{
+public:
+	HostMCP2515();
+	void reset(void);
+	void setBitrate(const uint32_t bitrate);
+	void setModeDelay(const uint32_t us);
+	uint32_t frameUs(const uint8_t len) const;
+	void select(void);
+	uint8_t transfer(const uint8_t data);
+	void receive(const hostCanFrame_t &frame);
+	uint64_t nextEvent(void) const;
+	void runEvents(const uint64_t nowUs);
+	bool interruptAsserted(void) const;
+	bool popSent(hostCanFrame_t &frame);
+	const hostCanStats_t &stats(void) const;
+	uint32_t unknownCommands(void) const;
+private:
+	uint8_t _read(const uint8_t address) const;
+	void _write(const uint8_t address, const uint8_t value);
+	void _startTransmit(const uint8_t buffer);
+	bool _accepts(const uint8_t firstFilter, const uint8_t filters, const uint8_t maskAddress,
+	              const uint32_t id) const;
+	void _store(const uint8_t buffer, const hostCanFrame_t &frame);
+	uint8_t _opmod(void) const;
+	uint8_t _regs[128];
+	uint8_t _command;
+	uint8_t _address;
+	uint8_t _position;
+	uint8_t _mask;
+	uint32_t _bitrate;
+	uint32_t _modeDelayUs;
+	uint64_t _modeDueUs;
+	uint64_t _txDueUs[3];
+	uint32_t _unknownCommands;
+	hostCanStats_t _stats;
+	std::deque<hostCanFrame_t> _sent;
+};
+
+#endif
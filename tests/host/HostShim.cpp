@@ -0,0 +1,604 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#include <deque>
+#include <string>
+#include "Arduino.h"
+#include "SPI.h"
+#include "avr/io.h"
+#include "avr/eeprom.h"
+#include "avr/sleep.h"
+#include "avr/wdt.h"
+#include "avr/power.h"
+#include "avr/boot.h"
+#include "HostShim.h"
+#include "HostMCP2515.h"
+
+#define HOST_PINS (32u)
+#define HOST_INTERRUPTS (2u)
+#define HOST_TIMER0_US (1024u)	// millis() interrupt of the Arduino core wakes the idle CPU
+
+typedef struct {
+	uint64_t atUs;
+	hostCanFrame_t frame;
+} hostBusFrame_t;
+
+uint32_t _hostBytesCopied = 0;
+
+static uint64_t _hostUs = 0;
+static uint64_t _hostStoppedUs = 0;	// time powered down, timer0 does not run
+static uint8_t _hostPins[HOST_PINS];
+static void (*_hostIsr[HOST_INTERRUPTS])(void);
+static uint32_t _hostIsrCalls = 0;
+static bool _hostInIsr = false;
+static uint8_t _hostSleepMode = SLEEP_MODE_IDLE;
+static bool _hostSleepEnabled = false;
+static int16_t _hostWdto = -1;
+static uint8_t _hostEeprom[E2END + 1];
+static std::string _hostSerialOut;
+static std::deque<char> _hostSerialIn;
+static uint32_t _hostRandom = 1;
+
+static HostMCP2515 _hostCan;
+static bool _hostCanAttached = false;
+static uint8_t _hostCanCs = 0xFF;
+static uint8_t _hostCanInt = 0xFF;
+static bool _hostCanSelected = false;
+static bool _hostCanIntLow = false;
+static std::deque<hostBusFrame_t> _hostBus;
+
+volatile uint8_t PORTB, PORTC, PORTD, DDRB, DDRC, DDRD, PINB, PINC, PIND;
+volatile uint8_t ADMUX, ADCSRA, TCCR1A, TCCR1B, TCCR1C, TIFR1, WDTCSR, EIFR, OSCCAL, SREG, MCUSR, EICRA,
+         EIMSK;
+volatile uint16_t ADCW, TCNT1, ADC = 1023;
+volatile uint8_t UCSR0A, UCSR0B, UCSR0C, UBRR0H, UBRR0L, UDR0;
+volatile uint16_t UBRR0;
+int __heap_start;
+int *__brkval;
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+// the attached interrupt sees a falling edge of CAN_INT
+static void _hostCheckInterrupt(void)
+{
+	if (!_hostCanAttached) {
+		return;
+	}
+	const bool low = _hostCan.interruptAsserted();
+	const bool falling = low && !_hostCanIntLow;
+	_hostCanIntLow = low;
+	const int interrupt = digitalPinToInterrupt(_hostCanInt);
+	if (falling && interrupt != NOT_AN_INTERRUPT && _hostIsr[interrupt] && !_hostInIsr) {
+		_hostInIsr = true;
+		_hostIsrCalls++;
+		_hostIsr[interrupt]();
+		_hostInIsr = false;
+	}
+}
+
+// run bus and controller events up to targetUs, optionally stop at the first interrupt
+static bool _hostRun(const uint64_t targetUs, const bool untilInterrupt)
+{
+	const uint32_t isrCalls = _hostIsrCalls;
+	// the driver's constructor runs before the emulator is constructed
+	while (_hostCanAttached) {
+		uint64_t next = _hostCan.nextEvent();
+		if (!_hostBus.empty() && _hostBus.front().atUs < next) {
+			next = _hostBus.front().atUs;
+		}
+		if (next > targetUs) {
+			break;
+		}
+		if (next > _hostUs) {
+			_hostUs = next;
+		}
+		while (!_hostBus.empty() && _hostBus.front().atUs <= _hostUs) {
+			_hostCan.receive(_hostBus.front().frame);
+			_hostBus.pop_front();
+		}
+		_hostCan.runEvents(_hostUs);
+		_hostCheckInterrupt();
+		if (untilInterrupt && _hostIsrCalls != isrCalls) {
+			return true;
+		}
+	}
+	if (targetUs > _hostUs) {
+		_hostUs = targetUs;
+	}
+	return false;
+}
+
+uint64_t hostMicros(void)
+{
+	return _hostUs;
+}
+
+void hostAdvance(const uint32_t us)
+{
+	(void)_hostRun(_hostUs + us, false);
+}
+
+uint32_t hostBytesCopied(void)
+{
+	return _hostBytesCopied;
+}
+
+void hostSerialInput(const char *data, const size_t length)
+{
+	_hostSerialIn.insert(_hostSerialIn.end(), data, data + length);
+}
+
+const char *hostSerialOutput(void)
+{
+	return _hostSerialOut.c_str();
+}
+
+void hostSerialClear(void)
+{
+	_hostSerialOut.clear();
+}
+
+void hostCanAttach(const uint8_t csPin, const uint8_t intPin, const uint32_t bitrate)
+{
+	_hostCanAttached = true;
+	_hostCanCs = csPin;
+	_hostCanInt = intPin;
+	_hostCan.setBitrate(bitrate);
+}
+
+uint32_t hostCanFrameUs(const uint8_t len)
+{
+	return _hostCan.frameUs(len);
+}
+
+void hostCanInject(const uint64_t atUs, const hostCanFrame_t &frame)
+{
+	hostBusFrame_t busFrame;
+	busFrame.atUs = atUs < hostCanBusFree() ? hostCanBusFree() : atUs;
+	busFrame.frame = frame;
+	_hostBus.push_back(busFrame);
+}
+
+uint64_t hostCanBusFree(void)
+{
+	return _hostBus.empty() || _hostBus.back().atUs < _hostUs ? _hostUs : _hostBus.back().atUs;
+}
+
+bool hostCanReceive(hostCanFrame_t &frame)
+{
+	return _hostCan.popSent(frame);
+}
+
+const hostCanStats_t &hostCanStats(void)
+{
+	return _hostCan.stats();
+}
+
+void hostCanSetModeDelay(const uint32_t us)
+{
+	_hostCan.setModeDelay(us);
+}
+
+// Arduino core
+
+void init(void)
+{
+	(void)memset(_hostEeprom, 0xFF, sizeof(_hostEeprom));
+	(void)memset(_hostPins, HIGH, sizeof(_hostPins));
+}
+
+void yield(void)
+{
+}
+
+unsigned long millis(void)
+{
+	hostAdvance(HOST_CALL_US);
+	return (unsigned long)((_hostUs - _hostStoppedUs) / 1000u);
+}
+
+unsigned long micros(void)
+{
+	hostAdvance(HOST_CALL_US);
+	return (unsigned long)(_hostUs - _hostStoppedUs);
+}
+
+void delay(unsigned long ms)
+{
+	hostAdvance(ms * 1000ul);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	hostAdvance(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+	(void)pin;
+	(void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+	hostAdvance(HOST_CALL_US);
+	if (pin == _hostCanCs && _hostCanAttached) {
+		if (!value && !_hostCanSelected) {
+			_hostCan.select();
+		}
+		_hostCanSelected = !value;
+		if (value) {
+			// register writes may change the interrupt output
+			_hostCheckInterrupt();
+		}
+	}
+	if (pin < HOST_PINS) {
+		_hostPins[pin] = value ? HIGH : LOW;
+	}
+}
+
+int digitalRead(uint8_t pin)
+{
+	hostAdvance(HOST_CALL_US);
+	if (pin == _hostCanInt && _hostCanAttached) {
+		return _hostCan.interruptAsserted() ? LOW : HIGH;
+	}
+	return pin < HOST_PINS ? _hostPins[pin] : LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+	(void)pin;
+	return 512;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode)
+{
+	if (interrupt >= HOST_INTERRUPTS) {
+		return;
+	}
+	_hostIsr[interrupt] = isr;
+	if (mode == LOW && digitalPinToInterrupt(_hostCanInt) == interrupt) {
+		// level interrupt fires right away
+		_hostCanIntLow = false;
+		_hostCheckInterrupt();
+	}
+}
+
+void detachInterrupt(uint8_t interrupt)
+{
+	if (interrupt < HOST_INTERRUPTS) {
+		_hostIsr[interrupt] = NULL;
+	}
+}
+
+void interrupts(void)
+{
+}
+
+void noInterrupts(void)
+{
+}
+
+long random(long howbig)
+{
+	// deterministic runs
+	_hostRandom = _hostRandom * 1103515245ul + 12345ul;
+	return howbig ? (long)((_hostRandom >> 8) % (uint32_t)howbig) : 0;
+}
+
+long random(long howsmall, long howbig)
+{
+	return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+	_hostRandom = seed ? seed : 1;
+}
+
+static char *_hostToString(unsigned long value, char *buffer, int radix, const bool negative)
+{
+	char digits[34];
+	uint8_t count = 0;
+	do {
+		const uint8_t digit = value % radix;
+		digits[count++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+		value /= radix;
+	} while (value);
+	char *out = buffer;
+	if (negative) {
+		*out++ = '-';
+	}
+	while (count) {
+		*out++ = digits[--count];
+	}
+	*out = 0;
+	return buffer;
+}
+
+char *itoa(int value, char *buffer, int radix)
+{
+	return ltoa(value, buffer, radix);
+}
+
+char *ltoa(long value, char *buffer, int radix)
+{
+	if (value < 0 && radix == 10) {
+		return _hostToString(-(unsigned long)value, buffer, radix, true);
+	}
+	return _hostToString(radix == 10 ? (unsigned long)value : (uint32_t)value, buffer, radix, false);
+}
+
+char *utoa(unsigned int value, char *buffer, int radix)
+{
+	return _hostToString(value, buffer, radix, false);
+}
+
+char *ultoa(unsigned long value, char *buffer, int radix)
+{
+	return _hostToString(value, buffer, radix, false);
+}
+
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer)
+{
+	(void)sprintf(buffer, "%*.*f", width, precision, value);
+	return buffer;
+}
+
+// Print, Serial, SPI
+
+size_t Print::print(const char *str)
+{
+	return write(str);
+}
+
+size_t Print::print(char c)
+{
+	return write((uint8_t)c);
+}
+
+size_t Print::print(int value, int base)
+{
+	return print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+	return print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base)
+{
+	char buffer[34];
+	return write(ltoa(value, buffer, base));
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+	char buffer[34];
+	return write(ultoa(value, buffer, base));
+}
+
+size_t Print::print(unsigned char value, int base)
+{
+	return print((unsigned long)value, base);
+}
+
+size_t Print::print(double value, int digits)
+{
+	char buffer[40];
+	return write(dtostrf(value, 0, digits, buffer));
+}
+
+size_t Print::print(const __FlashStringHelper *str)
+{
+	return write(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::println(const char *str)
+{
+	return print(str) + println();
+}
+
+size_t Print::println(void)
+{
+	return write("\r\n");
+}
+
+size_t Print::println(int value, int base)
+{
+	return print(value, base) + println();
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+	(void)baud;
+}
+
+void HardwareSerial::end()
+{
+}
+
+int HardwareSerial::available()
+{
+	return (int)_hostSerialIn.size();
+}
+
+int HardwareSerial::read()
+{
+	if (_hostSerialIn.empty()) {
+		return -1;
+	}
+	const char c = _hostSerialIn.front();
+	_hostSerialIn.pop_front();
+	return (uint8_t)c;
+}
+
+int HardwareSerial::peek()
+{
+	return _hostSerialIn.empty() ? -1 : (uint8_t)_hostSerialIn.front();
+}
+
+int HardwareSerial::availableForWrite()
+{
+	return 63;
+}
+
+size_t HardwareSerial::write(uint8_t data)
+{
+	_hostSerialOut.push_back((char)data);
+	return 1;
+}
+
+void SPIClass::begin(void)
+{
+}
+
+void SPIClass::end(void)
+{
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+	hostAdvance(HOST_SPI_BYTE_US);
+	if (_hostCanAttached && _hostCanSelected) {
+		return _hostCan.transfer(data);
+	}
+	return 0xFF;
+}
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+	(void)settings;
+}
+
+void SPIClass::endTransaction(void)
+{
+}
+
+// AVR libc
+
+uint8_t eeprom_read_byte(const uint8_t *address)
+{
+	return _hostEeprom[(uintptr_t)address & E2END];
+}
+
+void eeprom_update_byte(uint8_t *address, uint8_t value)
+{
+	_hostEeprom[(uintptr_t)address & E2END] = value;
+}
+
+void eeprom_read_block(void *dest, const void *address, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		static_cast<uint8_t *>(dest)[i] = _hostEeprom[((uintptr_t)address + i) & E2END];
+	}
+}
+
+void eeprom_update_block(const void *src, void *address, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		_hostEeprom[((uintptr_t)address + i) & E2END] = static_cast<const uint8_t *>(src)[i];
+	}
+}
+
+void set_sleep_mode(uint8_t mode)
+{
+	_hostSleepMode = mode;
+}
+
+void sleep_enable(void)
+{
+	_hostSleepEnabled = true;
+}
+
+void sleep_disable(void)
+{
+	_hostSleepEnabled = false;
+}
+
+void sleep_bod_disable(void)
+{
+}
+
+void sleep_cpu(void)
+{
+	if (!_hostSleepEnabled) {
+		// an interrupt before sleeping disabled sleep
+		return;
+	}
+	if (_hostSleepMode == SLEEP_MODE_IDLE) {
+		// timer0 or an attached interrupt wakes the CPU
+		(void)_hostRun((_hostUs / HOST_TIMER0_US + 1) * HOST_TIMER0_US, true);
+		return;
+	}
+	// powered down until the watchdog or an attached interrupt, millis() stops
+	const uint64_t startUs = _hostUs;
+	if (_hostWdto >= 0) {
+		(void)_hostRun(_hostUs + (16000ull << _hostWdto), true);
+	} else if (!_hostRun(_hostUs + 3600000000ull, true)) {
+		fprintf(stderr, "host: powered down without wake up source\n");
+		exit(2);
+	}
+	_hostStoppedUs += _hostUs - startUs;
+}
+
+void sleep_mode(void)
+{
+	sleep_enable();
+	sleep_cpu();
+	sleep_disable();
+}
+
+void wdt_enable(uint8_t timeout)
+{
+	_hostWdto = timeout;
+}
+
+void wdt_disable(void)
+{
+	_hostWdto = -1;
+}
+
+void wdt_reset(void)
+{
+}
+
+void power_adc_disable(void)
+{
+}
+
+void power_adc_enable(void)
+{
+}
+
+void power_all_disable(void)
+{
+}
+
+void power_all_enable(void)
+{
+}
+
+uint8_t boot_signature_byte_get(uint8_t address)
+{
+	return address;
+}
@@ -0,0 +1,152 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+/**
+ * @file HostShim.h
+ *
+ * Host build of the library for benchmarks and tests, see tests/Makefile. A test is a sketch: it
+ * includes MySensorsLightCan.h, runs from setup() / loop() under the library's main() and ends with
+ * exit().
+ *
+ * - Time is virtual. Each millis() / micros() / digitalRead() call costs HOST_CALL_US, each SPI byte
+ *   HOST_SPI_BYTE_US, delay() advances by its argument. Bus frames are delivered while time advances.
+ * - The MCP2515 is emulated at register level behind SPI (READ, WRITE, BIT MODIFY, READ STATUS,
+ *   RESET), incl. acceptance filters, RXB0 to RXB1 rollover, RXnOVR and the interrupt pin. The real
+ *   driver in hal/transport/CAN/driver runs unchanged on top of it.
+ * - Serial output is collected, input is fed by the test.
+ *
+ * Include C++ standard headers before the library: Arduino.h defines min() / max() and counts
+ * memcpy() / strncpy() for the benchmarks.
+ */
+
+#ifndef HostShim_h
+#define HostShim_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HOST_CALL_US (2u)		//!< virtual cost of a millis() / micros() / pin access
+#define HOST_SPI_BYTE_US (2u)	//!< virtual cost of one SPI byte (10MHz SPI incl. AVR overhead)
+
+/**
+ * @brief Extended (29 bit) %CAN data frame
+ */
+typedef struct {
+	uint32_t id;		//!< identifier
+	uint8_t len;		//!< data length 0..8
+	uint8_t data[8];	//!< data
+} hostCanFrame_t;
+
+/**
+ * @brief Emulator counters
+ */
+typedef struct {
+	uint32_t delivered;	//!< frames stored in RXB0 / RXB1
+	uint32_t filtered;	//!< frames rejected by the acceptance filters or the operation mode
+	uint32_t overflows;	//!< frames lost, both receive buffers full (RX0OVR / RX1OVR)
+	uint32_t sent;		//!< frames transmitted by the node
+	uint32_t modeChanges;	//!< operation mode changes (CANSTAT.OPMOD)
+} hostCanStats_t;
+
+/**
+ * @brief Current virtual time
+ * @return us since start
+ */
+uint64_t hostMicros(void);
+
+/**
+ * @brief Advance virtual time, delivers due bus frames
+ * @param us
+ */
+void hostAdvance(const uint32_t us);
+
+/**
+ * @brief Bytes copied by memcpy() / strncpy() since start
+ * @return bytes
+ */
+uint32_t hostBytesCopied(void);
+
+/**
+ * @brief Queue characters for Serial.read()
+ * @param data
+ * @param length
+ */
+void hostSerialInput(const char *data, const size_t length);
+
+/**
+ * @brief Serial output since the last hostSerialClear()
+ * @return zero terminated output
+ */
+const char *hostSerialOutput(void);
+
+/**
+ * @brief Discard collected serial output
+ */
+void hostSerialClear(void);
+
+/**
+ * @brief Connect the emulated MCP2515, call from preHwInit()
+ * @param csPin chip select, CAN_CS
+ * @param intPin interrupt output, CAN_INT
+ * @param bitrate bit/s of the bus, used for frame times
+ */
+void hostCanAttach(const uint8_t csPin, const uint8_t intPin, const uint32_t bitrate);
+
+/**
+ * @brief Bus time of an extended data frame incl. worst case stuffing and interframe space
+ * @param len data length
+ * @return us
+ */
+uint32_t hostCanFrameUs(const uint8_t len);
+
+/**
+ * @brief Put a frame of another node on the bus
+ * @param atUs virtual time the frame is complete, not before the previously queued frame
+ * @param frame
+ */
+void hostCanInject(const uint64_t atUs, const hostCanFrame_t &frame);
+
+/**
+ * @brief Time the last queued frame is complete
+ * @return us, current time if nothing is queued
+ */
+uint64_t hostCanBusFree(void);
+
+/**
+ * @brief Take the oldest frame sent by the node
+ * @param frame
+ * @return false if none
+ */
+bool hostCanReceive(hostCanFrame_t &frame);
+
+/**
+ * @brief Emulator counters
+ * @return counters since start
+ */
+const hostCanStats_t &hostCanStats(void);
+
+/**
+ * @brief Delay of CANSTAT.OPMOD following a mode request in CANCTRL.REQOP
+ *
+ * The MCP2515 changes the mode only after pending transmissions and at a bus idle, 0 = immediate.
+ * @param us
+ */
+void hostCanSetModeDelay(const uint32_t us);
+
+#endif
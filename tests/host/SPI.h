@@ -0,0 +1,49 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#ifndef HostSPI_h
+#define HostSPI_h
+
+#include <stdint.h>
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+struct SPISettings {
+	SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+	{
+		(void)clock;
+		(void)bitOrder;
+		(void)dataMode;
+	}
+};
+
+// bytes go to the emulated MCP2515 while its chip select is low, see HostShim.h
+class SPIClass
+{
+public:
+	void begin(void);
+	void end(void);
+	uint8_t transfer(uint8_t data);
+	void beginTransaction(SPISettings settings);
+	void endTransaction(void);
+};
+extern SPIClass SPI;
+
+#endif
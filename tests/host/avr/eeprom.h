@@ -0,0 +1,32 @@
+/*
+ * The MySensors Arduino library handles the wireless radio link and protocol
+ * between your home built sensors/actuators and HA controller of choice.
+ * The sensors forms a self healing radio network with optional repeaters. Each
+ * repeater and gateway builds a routing tables in EEPROM which keeps track of the
+ * network topology allowing messages to be routed to nodes.
+ *
+ * Created by Henrik Ekblad <henrik.ekblad@mysensors.org>
+ * Copyright (C) 2013-2020 Sensnology AB
+ * Full contributor list: https://github.com/mysensors/MySensors/graphs/contributors
+ *
+ * Documentation: http://www.mysensors.org
+ * Support Forum: http://forum.mysensors.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ */
+
+#ifndef HostAvrEeprom_h
+#define HostAvrEeprom_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 1 KiB EEPROM as on ATmega328P, erased (0xFF) at start up
+uint8_t eeprom_read_byte(const uint8_t *address);
+void eeprom_update_byte(uint8_t *address, uint8_t value);
+void eeprom_read_block(void *dest, const void *address, size_t n);
+void eeprom_update_block(const void *src, void *address, size_t n);
+
+#endif